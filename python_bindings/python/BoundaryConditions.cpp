@@ -253,5 +253,13 @@ void defineBoundaryConditions() {
 
     p::def("mirror_interior", &mirror_interior_bounds, p::args("source", "bounds"));
 
+    // padded_copy
+
+    p::def("padded_copy", &hb::padded_copy, (p::arg("bounded"), p::arg("vector_size") = 16),
+           "Materialize a Func with a boundary condition imposed on it into a padded "
+           "copy of the region that its consumers need, so that the consumers read it "
+           "with no clamps or selects. The returned Func is computed at root, with its "
+           "innermost dimension vectorized and its outermost dimension parallelized.");
+
     return;
 }
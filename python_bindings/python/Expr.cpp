@@ -64,9 +64,10 @@ void defineExpr() {
                                       "The following math global functions are also available::\n"
                                       "Unary:\n"
                                       "  abs acos acosh asin asinh atan atanh ceil cos cosh exp\n"
-                                      "  fast_exp fast_log floor log round sin sinh sqrt tan tanh\n"
+                                      "  fast_atan fast_cos fast_exp fast_log fast_sin floor log round\n"
+                                      "  sin sinh sqrt tan tanh\n"
                                       "Binary:\n"
-                                      "  hypot fast_pow max min pow\n\n"
+                                      "  atan2 fast_atan2 hypot fast_pow max min pow\n\n"
                                       "Ternary:\n"
                                       "  clamp(x, lo, hi)                  -- Clamp expression to [lo, hi]\n"
                                       "  select(cond, if_true, if_false)   -- Return if_true if cond else if_false\n")
@@ -47,27 +47,49 @@ h::Realization python_object_to_realization(p::object obj) {
     return h::Realization(buffers);
 }
 
+// Releases the Python global interpreter lock for its lifetime, so
+// that other Python threads can run while Halide compiles or runs a
+// pipeline. Python objects must not be touched while one is alive.
+class ScopedReleaseGIL {
+    PyThreadState *state;
+
+public:
+    ScopedReleaseGIL() : state(PyEval_SaveThread()) {}
+    ~ScopedReleaseGIL() {
+        PyEval_RestoreThread(state);
+    }
+};
+
 template <typename... Args>
 p::object func_realize(h::Func &f, Args... args) {
-    return realization_to_python_object(f.realize(args...));
+    h::Realization r = [&]() {
+        ScopedReleaseGIL release_gil;
+        return f.realize(args...);
+    }();
+    return realization_to_python_object(r);
 }
 
 template <typename... Args>
 void func_realize_into(h::Func &f, Args... args) {
+    ScopedReleaseGIL release_gil;
     f.realize(args...);
 }
 
 template <typename... Args>
 void func_realize_tuple(h::Func &f, p::tuple obj, Args... args) {
-    f.realize(python_object_to_realization(obj), args...);
+    h::Realization r = python_object_to_realization(obj);
+    ScopedReleaseGIL release_gil;
+    f.realize(r, args...);
 }
 
 void func_compile_jit0(h::Func &that) {
+    ScopedReleaseGIL release_gil;
     that.compile_jit();
     return;
 }
 
 void func_compile_jit1(h::Func &that, const h::Target &target = h::get_target_from_environment()) {
+    ScopedReleaseGIL release_gil;
     that.compile_jit(target);
     return;
 }
@@ -77,6 +99,7 @@ void func_compile_to_bitcode0(h::Func &that, const std::string &filename,
                               const std::string fn_name = "",
                               const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_bitcode(filename, args_vec, fn_name, target);
 }
 
@@ -87,6 +110,7 @@ void func_compile_to_object0(h::Func &that, const std::string &filename,
                              const std::string fn_name = "",
                              const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_object(filename, args_vec, fn_name, target);
 }
 
@@ -97,6 +121,7 @@ void func_compile_to_header0(h::Func &that, const std::string &filename,
                              const std::string fn_name = "",
                              const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_header(filename, args_vec, fn_name, target);
 }
 
@@ -107,6 +132,7 @@ void func_compile_to_assembly0(h::Func &that, const std::string &filename,
                                const std::string fn_name = "",
                                const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_assembly(filename, args_vec, fn_name, target);
 }
 
@@ -117,6 +143,7 @@ void func_compile_to_c0(h::Func &that, const std::string &filename,
                         const std::string fn_name = "",
                         const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_c(filename, args_vec, fn_name, target);
 }
 
@@ -127,6 +154,7 @@ void func_compile_to_file0(h::Func &that, const std::string &filename_prefix,
                            const std::string fn_name = "",
                            const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_file(filename_prefix, args_vec, fn_name, target);
 }
 
@@ -138,6 +166,7 @@ void func_compile_to_lowered_stmt0(h::Func &that,
                                    h::StmtOutputFormat fmt = h::Text,
                                    const h::Target &target = h::get_target_from_environment()) {
     auto args_vec = python_collection_to_vector<h::Argument>(args);
+    ScopedReleaseGIL release_gil;
     that.compile_to_lowered_stmt(filename, args_vec, fmt, target);
 }
 
@@ -549,6 +578,14 @@ void defineFunc() {
         .def("unroll", &func_unroll0<Func>, p::args("self", "var"),
              p::return_internal_reference<1>());
 
+    func_class.def("unroll_and_jam", &func_unroll_and_jam<Func>, p::args("self", "var", "factor"),
+                   p::return_internal_reference<1>(),
+                   "Split a dimension by the given factor, unroll the inner "
+                   "dimension, and move it to the innermost position (just outside "
+                   "any vectorized dimension), so that the unrolled copies of the "
+                   "loop body sit next to each other. After this call, var refers "
+                   "to the outer dimension of the split.");
+
     func_class.def("bound", &Func::bound, p::args("self", "var", "min", "extent"),
                    p::return_internal_reference<1>(),
                    "Statically declare that the range over which a function should "
@@ -56,6 +56,11 @@ FuncOrStage &func_unroll1(FuncOrStage &that, hh::VarOrRVar var, int factor) {
     return that.unroll(var, factor);
 }
 
+template <typename FuncOrStage>
+FuncOrStage &func_unroll_and_jam(FuncOrStage &that, hh::VarOrRVar var, int factor) {
+    return that.unroll_and_jam(var, factor);
+}
+
 template <typename FuncOrStage>
 FuncOrStage &func_tile0(FuncOrStage &that, hh::VarOrRVar x, hh::VarOrRVar y,
                         hh::VarOrRVar xo, hh::VarOrRVar yo,
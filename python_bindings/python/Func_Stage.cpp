@@ -79,6 +79,14 @@ void defineStage() {
         .def("unroll", &func_unroll0<Stage>, p::args("self", "var"),
              p::return_internal_reference<1>());
 
+    stage_class.def("unroll_and_jam", &func_unroll_and_jam<Stage>, p::args("self", "var", "factor"),
+                    p::return_internal_reference<1>(),
+                    "Split a dimension by the given factor, unroll the inner "
+                    "dimension, and move it to the innermost position (just outside "
+                    "any vectorized dimension), so that the unrolled copies of the "
+                    "loop body sit next to each other. After this call, var refers "
+                    "to the outer dimension of the split.");
+
     stage_class.def("tile", &func_tile0<Stage>, p::args("self", "x", "y", "xo", "yo", "xi", "yi", "xfactor", "yfactor"),
                     p::return_internal_reference<1>(),
                     "Split two dimensions at once by the given factors, and then "
@@ -271,6 +271,38 @@ void defineOperators() {
            "various ways to write this yourself, but they contain numerous "
            "gotchas and don't always compile to good code, so use this instead.");
 
+    p::def("widening_add", &h::widening_add, p::args("a", "b"),
+           "Add two integers, returning a result of twice the bit width, so "
+           "the sum can't overflow.");
+
+    p::def("widening_mul", &h::widening_mul, p::args("a", "b"),
+           "Multiply two integers, returning a result of twice the bit width, "
+           "so the product can't overflow.");
+
+    p::def("saturating_add", &h::saturating_add, p::args("a", "b"),
+           "Add two integers, clamping the result to the range of the type "
+           "instead of wrapping around.");
+
+    p::def("saturating_sub", &h::saturating_sub, p::args("a", "b"),
+           "Subtract two integers, clamping the result to the range of the "
+           "type instead of wrapping around.");
+
+    p::def("halving_add", &h::halving_add, p::args("a", "b"),
+           "Compute (a + b)/2, rounding down, without overflow in the "
+           "intermediate sum.");
+
+    p::def("rounding_halving_add", &h::rounding_halving_add, p::args("a", "b"),
+           "Compute (a + b + 1)/2, i.e. the average of a and b rounding up, "
+           "without overflow in the intermediate sum.");
+
+    p::def("rounding_shift_right", &h::rounding_shift_right, p::args("a", "b"),
+           "Shift a right by b bits, rounding to the nearest integer (ties "
+           "round up) instead of down.");
+
+    p::def("rounding_mul_shift_right", &h::rounding_mul_shift_right, p::args("a", "b", "q"),
+           "Compute the product of a and b shifted right by q bits, rounding "
+           "to nearest, and saturating to the range of the type.");
+
     p::def("select", &select0, p::args("condition", "true_value", "false_value"),
            "Returns an expression similar to the ternary operator in C, except "
            "that it always evaluates all arguments. If the first argument is "
@@ -474,6 +506,28 @@ void defineOperators() {
            "accurate up to the last 5 bits of the mantissa. Gets worse when "
            "approaching overflow. Vectorizes cleanly.");
 
+    p::def("fast_sin", &h::fast_sin, (p::arg("x"), p::arg("max_ulp_error") = 27),
+           "Fast approximate cleanly vectorizable sine for Float(32). The "
+           "error is at most max_ulp_error units in the last place, which "
+           "can be as low as 3. Returns NaN for arguments of magnitude 32768 "
+           "or more, infinities and NaNs. Vectorizes cleanly.");
+
+    p::def("fast_cos", &h::fast_cos, (p::arg("x"), p::arg("max_ulp_error") = 27),
+           "Fast approximate cleanly vectorizable cosine for Float(32). The "
+           "error is at most max_ulp_error units in the last place, which "
+           "can be as low as 3. Returns NaN for arguments of magnitude 32768 "
+           "or more, infinities and NaNs. Vectorizes cleanly.");
+
+    p::def("fast_atan", &h::fast_atan, (p::arg("x"), p::arg("max_ulp_error") = 12),
+           "Fast approximate cleanly vectorizable arctangent for Float(32). "
+           "The error is at most max_ulp_error units in the last place, "
+           "which can be as low as 3. Vectorizes cleanly.");
+
+    p::def("fast_atan2", &h::fast_atan2, (p::arg("y"), p::arg("x"), p::arg("max_ulp_error") = 13),
+           "Fast approximate cleanly vectorizable angle of a gradient for "
+           "Float(32). The error is at most max_ulp_error units in the last "
+           "place, which can be as low as 4. Vectorizes cleanly.");
+
     p::def("fast_pow", &h::fast_pow, p::args("x"),
            "Fast approximate cleanly vectorizable pow for Float(32). Returns "
            "nonsense for x < 0.0f. Accurate up to the last 5 bits of the "
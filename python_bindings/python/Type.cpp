@@ -30,6 +30,10 @@ std::string type_code_to_string(const h::Type &t) {
         code_string = "Handle";
         break;
 
+    case h::Type::BFloat:
+        code_string = "BFloat";
+        break;
+
     default:
         code_string = "unknown";
     }
@@ -73,7 +77,9 @@ void defineType() {
         .def("is_scalar", &Type::is_scalar, p::arg("self"),
              "Is this type a scalar type? (lanes == 1)")
         .def("is_float", &Type::is_float, p::arg("self"),
-             "Is this type a floating point type (float or double).")
+             "Is this type a floating point type (float, double, or bfloat).")
+        .def("is_bfloat", &Type::is_bfloat, p::arg("self"),
+             "Is this type a bfloat floating point type?")
         .def("is_int", &Type::is_int, p::arg("self"),
              "Is this type a signed integer type?")
         .def("is_uint", &Type::is_uint, p::arg("self"),
@@ -109,6 +115,10 @@ void defineType() {
            (p::arg("bits"), p::arg("lanes") = 1),
            "Constructing a floating-point type");
 
+    p::def("BFloat", h::BFloat,
+           (p::arg("bits"), p::arg("lanes") = 1),
+           "Constructing a bfloat floating-point type");
+
     p::def("Bool", h::Bool,
            (p::arg("lanes") = 1),
            "Construct a boolean type");
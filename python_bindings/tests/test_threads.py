@@ -0,0 +1,71 @@
+#!/usr/bin/python3
+
+# realize and compile_jit release the GIL, so pipelines run from
+# several Python threads should overlap. This checks the results, and
+# reports how throughput scales with the number of threads.
+
+import threading
+import time
+
+import halide as h
+
+def make_pipeline(k):
+    x = h.Var("x")
+    y = h.Var("y")
+    f = h.Func("f")
+    # Enough work per pixel that realize dominates the call overhead.
+    e = h.cast(h.Float(32), x + y + k)
+    for i in range(20):
+        e = h.sqrt(e * e + 1.0)
+    f[x, y] = e
+    f.vectorize(x, 8)
+    f.compile_jit()
+    return f
+
+def run(funcs, iterations, size):
+    def work(f):
+        for i in range(iterations):
+            f.realize(size, size)
+
+    threads = [threading.Thread(target=work, args=(f,)) for f in funcs]
+    start = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return time.time() - start
+
+def test_threads():
+    num_threads = 4
+    iterations = 10
+    size = 512
+
+    # Compile from several threads at once.
+    funcs = [None] * num_threads
+    def compile(i):
+        funcs[i] = make_pipeline(i)
+    threads = [threading.Thread(target=compile, args=(i,)) for i in range(num_threads)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    for i, f in enumerate(funcs):
+        output = h.Image(h.Float(32), f.realize(4, 4))
+        expected = float(3 + i)
+        for j in range(20):
+            expected = (expected * expected + 1.0) ** 0.5
+        assert abs(output(1, 2) - expected) < expected * 1e-5
+
+    serial = run(funcs[:1], iterations * num_threads, size)
+    parallel = run(funcs, iterations, size)
+
+    print("%d realizations on one thread: %f s" % (iterations * num_threads, serial))
+    print("%d realizations on %d threads: %f s" % (iterations * num_threads, num_threads, parallel))
+    print("Speedup: %f" % (serial / parallel))
+
+    print("Success!")
+    return 0
+
+if __name__ == "__main__":
+    test_threads()
@@ -0,0 +1,297 @@
+#include <cstdlib>
+
+#include "AllocationPlacement.h"
+#include "Bounds.h"
+#include "ExprUsesVar.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRPrinter.h"
+#include "Scope.h"
+#include "Simplify.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+int64_t max_stack_allocation_bytes() {
+    string limit = get_env_variable("HL_MAX_STACK_ALLOCATION");
+    if (!limit.empty()) {
+        return std::atoll(limit.c_str());
+    }
+    return 1024 * 1024;
+}
+
+// Substitute in the values of the enclosing lets.
+class ExpandLets : public IRMutator {
+    using IRMutator::visit;
+
+    const Scope<Expr> &lets;
+
+    void visit(const Variable *op) {
+        if (lets.contains(op->name)) {
+            expr = mutate(lets.get(op->name));
+        } else {
+            expr = op;
+        }
+    }
+
+public:
+    ExpandLets(const Scope<Expr> &l) : lets(l) {}
+};
+
+class PlaceAllocations : public IRMutator {
+    using IRMutator::visit;
+
+    // The values of the enclosing integer lets.
+    Scope<Expr> lets;
+
+    // The bounds of the enclosing loop variables, in terms of
+    // variables defined outside of all loops.
+    Scope<Interval> loops;
+
+    // The names defined since the top of the current task (the body
+    // of a parallel loop, or the whole pipeline), which per-task
+    // allocations can't be hoisted above.
+    Scope<int> region_vars;
+
+    // The number of serial loops between the top of the current task
+    // and the node being mutated.
+    int serial_loops = 0;
+
+    struct PerTaskAllocation {
+        string name;
+        Type type;
+        vector<Expr> extents;
+        Expr condition;
+    };
+
+    // The allocations hoisted to the top of the current task.
+    vector<PerTaskAllocation> per_task;
+
+    Interval bounds_of(Expr e) {
+        e = simplify(ExpandLets(lets).mutate(e));
+        return bounds_of_expr_in_scope(e, loops);
+    }
+
+    Interval loop_bounds(const For *op) {
+        return Interval(bounds_of(op->min).min, bounds_of(op->min + op->extent - 1).max);
+    }
+
+    void visit(const LetStmt *op) {
+        Type t = op->value.type();
+        bool is_int = t.is_scalar() && (t.is_int() || t.is_uint());
+        if (is_int) {
+            lets.push(op->name, op->value);
+        }
+        region_vars.push(op->name, 0);
+        Stmt body = mutate(op->body);
+        region_vars.pop(op->name);
+        if (is_int) {
+            lets.pop(op->name);
+        }
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, op->value, body);
+        }
+    }
+
+    void visit(const For *op) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Allocations in device code are the business of the
+            // device backends.
+            stmt = op;
+            return;
+        }
+
+        Stmt body;
+        if (op->for_type == ForType::Serial ||
+            op->for_type == ForType::Unrolled) {
+            loops.push(op->name, loop_bounds(op));
+            region_vars.push(op->name, 0);
+            serial_loops++;
+            body = mutate(op->body);
+            serial_loops--;
+            region_vars.pop(op->name);
+            loops.pop(op->name);
+        } else {
+            // Each iteration of a parallel loop is a separate task,
+            // which may run on a different thread, so it gets its own
+            // allocations.
+            PlaceAllocations region;
+            region.lets.set_containing_scope(&lets);
+            region.loops.set_containing_scope(&loops);
+            region.loops.push(op->name, loop_bounds(op));
+            body = region.mutate(op->body);
+            body = region.allocate_per_task(body);
+        }
+
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+        }
+    }
+
+    void visit(const Allocate *op) {
+        if (op->memory_type == MemoryType::Stack ||
+            op->memory_type == MemoryType::Register) {
+            // Bound the size by a constant.
+            vector<Expr> extents;
+            int64_t size = op->type.bytes();
+            for (Expr e : op->extents) {
+                Interval i = bounds_of(e);
+                Expr c;
+                if (i.has_upper_bound()) {
+                    c = find_constant_bound(simplify(i.max), Direction::Upper);
+                }
+                const int64_t *extent = c.defined() ? as_const_int(c) : nullptr;
+                user_assert(extent)
+                    << "Func " << op->name << " is stored in " << op->memory_type
+                    << " memory, but the extent " << e << " of its allocation"
+                    << " could not be bounded by a constant.\n";
+                size *= std::max(*extent, (int64_t)0);
+                extents.push_back(c);
+            }
+            int64_t limit = max_stack_allocation_bytes();
+            user_assert(size <= limit)
+                << "Func " << op->name << " is stored in " << op->memory_type
+                << " memory, but its allocation may be as large as " << size
+                << " bytes, which exceeds the stack allocation limit of " << limit
+                << " bytes. The limit can be raised by setting HL_MAX_STACK_ALLOCATION.\n";
+            stmt = Allocate::make(op->name, op->type, extents, op->condition,
+                                  mutate(op->body), op->new_expr, op->free_function, op->memory_type);
+            return;
+        }
+
+        if (op->memory_type != MemoryType::PerTask ||
+            serial_loops == 0 ||
+            op->new_expr.defined()) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        // Bound the size over the serial loops of this region, in
+        // terms of the variables defined at its top.
+        vector<Expr> extents;
+        for (Expr e : op->extents) {
+            Interval i = bounds_of(e);
+            if (!i.has_upper_bound() || expr_uses_vars(i.max, region_vars)) {
+                user_warning << "Could not hoist the per-task allocation of " << op->name
+                             << ", because its extent " << e
+                             << " could not be bounded outside of its enclosing loops."
+                             << " It will be allocated on the heap in each iteration instead.\n";
+                IRMutator::visit(op);
+                return;
+            }
+            extents.push_back(simplify(i.max));
+        }
+
+        debug(3) << "Hoisting per-task allocation " << op->name << " out of "
+                 << serial_loops << " serial loops\n";
+
+        // The allocation is needed if any of the iterations would
+        // have made it. If the condition depends on the serial loops,
+        // we can't tell which, so assume it is.
+        Expr condition = op->condition;
+        if (expr_uses_vars(condition, region_vars)) {
+            condition = const_true();
+        }
+
+        bool found = false;
+        for (PerTaskAllocation &p : per_task) {
+            if (p.name == op->name) {
+                // The same Func is realized in several places (e.g. in
+                // different specializations). Share one allocation big
+                // enough for all of them.
+                internal_assert(p.extents.size() == extents.size());
+                for (size_t i = 0; i < extents.size(); i++) {
+                    p.extents[i] = simplify(max(p.extents[i], extents[i]));
+                }
+                p.condition = simplify(p.condition || condition);
+                found = true;
+            }
+        }
+        if (!found) {
+            per_task.push_back({op->name, op->type, extents, condition});
+        }
+
+        stmt = mutate(op->body);
+    }
+
+public:
+    Stmt allocate_per_task(Stmt s) {
+        for (const PerTaskAllocation &p : per_task) {
+            s = Allocate::make(p.name, p.type, p.extents, p.condition, s, Expr(), std::string(), MemoryType::PerTask);
+        }
+        return s;
+    }
+};
+
+class CheckRegisterAllocations : public IRVisitor {
+    using IRVisitor::visit;
+
+    Scope<int> registers;
+    Scope<Expr> lets;
+
+    void check_index(const string &name, Expr index) {
+        if (!registers.contains(name)) {
+            return;
+        }
+        if (const Ramp *r = index.as<Ramp>()) {
+            index = r->base;
+        }
+        user_assert(is_const(simplify(ExpandLets(lets).mutate(index))))
+            << "Func " << name << " is stored in Register memory, but is accessed at"
+            << " the non-constant index " << index << ". All loops over it"
+            << " should be unrolled or vectorized.\n";
+    }
+
+    void visit(const LetStmt *op) {
+        lets.push(op->name, op->value);
+        IRVisitor::visit(op);
+        lets.pop(op->name);
+    }
+
+    void visit(const Allocate *op) {
+        if (op->memory_type == MemoryType::Register) {
+            registers.push(op->name, 0);
+            IRVisitor::visit(op);
+            registers.pop(op->name);
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    void visit(const Load *op) {
+        check_index(op->name, op->index);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Store *op) {
+        check_index(op->name, op->index);
+        IRVisitor::visit(op);
+    }
+};
+
+}  // namespace
+
+Stmt place_allocations(Stmt s) {
+    PlaceAllocations p;
+    s = p.mutate(s);
+    return p.allocate_per_task(s);
+}
+
+void check_register_allocations(Stmt s) {
+    CheckRegisterAllocations c;
+    s.accept(&c);
+}
+
+}
+}
@@ -0,0 +1,32 @@
+#ifndef HALIDE_ALLOCATION_PLACEMENT_H
+#define HALIDE_ALLOCATION_PLACEMENT_H
+
+/** \file
+ * Defines the lowering passes that honor the memory types requested
+ * with Func::store_in.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Give allocations placed on the stack or in registers a constant
+ * size, and check it against the stack allocation limit. PerTask
+ * allocations are hoisted out of the serial loops around them to the
+ * top of the innermost enclosing parallel loop (or of the whole
+ * pipeline), sized for the largest iteration, so that they are made
+ * once per iteration of that parallel loop instead of once per
+ * iteration of the serial loops. Should be run after
+ * storage flattening. */
+Stmt place_allocations(Stmt s);
+
+/** Check that every access to an allocation placed in registers uses
+ * a constant index. Should be run after unrolling and
+ * vectorization. */
+void check_register_allocations(Stmt s);
+
+}
+}
+
+#endif
@@ -47,9 +47,12 @@ vector<ApplySplitResult> apply_split(const Split &split, bool is_update, string
         } else if (is_one(split.factor)) {
             // The split factor trivially divides the old extent,
             // but we know nothing new about the outer dimension.
-        } else if (tail == TailStrategy::GuardWithIf) {
+        } else if (tail == TailStrategy::GuardWithIf ||
+                   tail == TailStrategy::Predicate) {
             // It's an exact split but we failed to prove that the
-            // extent divides the factor. Use predication.
+            // extent divides the factor. Use predication. For
+            // TailStrategy::Predicate, vectorization turns the if
+            // statement into masked loads and stores.
 
             // Make a var representing the original var minus its
             // min. It's important that this is a single Var so
@@ -210,6 +210,32 @@ Func mirror_interior(const Func &source,
     return bounded;
 }
 
+Func padded_copy(const Func &bounded, int vector_size) {
+    user_assert(bounded.defined())
+        << "padded_copy called with undefined Func " << bounded.name() << "\n";
+    user_assert(vector_size >= 1)
+        << "padded_copy called with vector_size " << vector_size << "\n";
+    std::vector<Var> args(bounded.args());
+
+    // The boundary condition gets inlined into the copy, where the
+    // clamps and selects it uses are marked likely, so the copy's
+    // innermost loop gets partitioned into a steady state with none
+    // of them.
+    Func padded("padded_copy");
+    padded(args) = bounded(args);
+    padded.compute_root();
+    if (!args.empty()) {
+        if (vector_size > 1) {
+            padded.vectorize(args[0], vector_size);
+        }
+        if (args.size() > 1) {
+            padded.parallel(args.back());
+        }
+    }
+
+    return padded;
+}
+
 }
 
 }
@@ -260,6 +260,31 @@ inline NO_INLINE Func mirror_interior(const T &func_like, Bounds&&... bounds) {
 }
 // @}
 
+/** Materialize a Func with a boundary condition imposed on it (the
+ *  result of any of the functions above) into a padded copy of the
+ *  region that its consumers need, so that the consumers read it
+ *  with no clamps or selects. The boundary conditions above rely on
+ *  loop partitioning to remove the clamps from the consumer's inner
+ *  loops, which doesn't work for every schedule (e.g. tiled or
+ *  parallel ones). The copy costs one extra pass over the region, but
+ *  its own loops are simple enough to always partition: each row is
+ *  a dense vector copy of the interior, with broadcasts of the edge
+ *  or exterior value on either side.
+ *
+ *  The returned Func is computed at root, with its innermost
+ *  dimension vectorized by vector_size and its outermost dimension
+ *  parallelized. It may be rescheduled (e.g. with compute_at), but
+ *  the innermost dimension should stay the innermost loop.
+ *
+ *  For example, to blur an image without clamps in the blur's inner
+ *  loop:
+ \code
+ Func padded = BoundaryConditions::padded_copy(BoundaryConditions::repeat_edge(input));
+ blur(x, y) = (padded(x - 1, y) + padded(x, y) + padded(x + 1, y)) / 3;
+ \endcode
+ */
+EXPORT Func padded_copy(const Func &bounded, int vector_size = 16);
+
 }
 
 }
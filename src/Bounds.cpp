@@ -11,6 +11,7 @@
 #include "Var.h"
 #include "Debug.h"
 #include "ExprUsesVar.h"
+#include "FixedPoint.h"
 #include "IRMutator.h"
 #include "CSE.h"
 
@@ -667,6 +668,8 @@ private:
         } else if (op->is_intrinsic(Call::memoize_expr)) {
             internal_assert(op->args.size() >= 1);
             op->args[0].accept(this);
+        } else if (is_fixed_point_intrinsic(op)) {
+            lower_fixed_point_intrinsic(op).accept(this);
         } else if (op->call_type == Call::Halide) {
             bounds_of_func(op->name, op->value_index, op->type);
         } else {
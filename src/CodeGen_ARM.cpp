@@ -988,19 +988,26 @@ string CodeGen_ARM::mcpu() const {
 }
 
 string CodeGen_ARM::mattrs() const {
+    string fp16;
+    if (target.has_feature(Target::ARMFp16)) {
+        // On 32-bit ARM this only gives conversions between half and
+        // single precision. On 64-bit ARM it also gives half precision
+        // arithmetic.
+        fp16 = target.bits == 32 ? ",+fp16" : "+fullfp16";
+    }
     if (target.bits == 32) {
         if (target.has_feature(Target::ARMv7s)) {
-            return "+neon";
+            return "+neon" + fp16;
         } if (!target.has_feature(Target::NoNEON)) {
-            return "+neon";
+            return "+neon" + fp16;
         } else {
-            return "-neon";
+            return "-neon" + fp16;
         }
     } else {
         if (target.os == Target::IOS || target.os == Target::OSX) {
-            return "+reserve-x18";
+            return "+reserve-x18" + (fp16.empty() ? "" : "," + fp16);
         } else {
-            return "";
+            return fp16;
         }
     }
 }
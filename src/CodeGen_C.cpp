@@ -7,6 +7,7 @@
 #include "IROperator.h"
 #include "Param.h"
 #include "Var.h"
+#include "FixedPoint.h"
 #include "Lerp.h"
 #include "Simplify.h"
 
@@ -978,6 +979,8 @@ void CodeGen_C::visit(const Call *op) {
         internal_assert(op->args.size() == 3);
         Expr e = lower_lerp(op->args[0], op->args[1], op->args[2]);
         rhs << print_expr(e);
+    } else if (is_fixed_point_intrinsic(op)) {
+        rhs << print_expr(lower_fixed_point_intrinsic(op));
     } else if (op->is_intrinsic(Call::absd)) {
         internal_assert(op->args.size() == 2);
         Expr a = op->args[0];
@@ -1157,6 +1160,9 @@ void CodeGen_C::visit(const Call *op) {
         user_assert((op->args.size() == 3) && is_one(op->args[1]))
             << "Only prefetch of 1 cache line is supported in C backend.\n";
         rhs << "__builtin_prefetch(" << print_expr(op->args[0]) << ", 1)";
+    } else if (op->is_intrinsic(Call::nontemporal_stores)) {
+        // Streaming stores are left to the C compiler.
+        rhs << print_expr(0);
     } else if (op->is_intrinsic(Call::indeterminate_expression)) {
         user_error << "Indeterminate expression occurred during constant-folding.\n";
     } else if (op->call_type == Call::Intrinsic ||
@@ -1352,7 +1358,7 @@ void CodeGen_C::visit(const Allocate *op) {
                            << op->name << " is constant but exceeds 2^31 - 1.\n";
             } else {
                 size_id = print_expr(Expr(static_cast<int32_t>(constant_size)));
-                if (can_allocation_fit_on_stack(stack_bytes)) {
+                if (can_allocation_fit_on_stack(stack_bytes, op->memory_type)) {
                     on_stack = true;
                 }
             }
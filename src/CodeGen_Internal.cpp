@@ -82,7 +82,12 @@ void unpack_closure(const Closure& closure,
 
 llvm::Type *llvm_type_of(LLVMContext *c, Halide::Type t) {
     if (t.lanes() == 1) {
-        if (t.is_float()) {
+        if (t.is_bfloat()) {
+            // LLVM has no bfloat type. These are only ever loaded,
+            // stored and reinterpreted by the time they get here; see
+            // EmulateFloat16Math.
+            return llvm::Type::getIntNTy(*c, t.bits());
+        } else if (t.is_float()) {
             switch (t.bits()) {
             case 16:
                 return llvm::Type::getHalfTy(*c);
@@ -177,8 +182,18 @@ bool function_takes_user_context(const std::string &name) {
     return starts_with(name, "halide_error_");
 }
 
-bool can_allocation_fit_on_stack(int64_t size) {
+bool can_allocation_fit_on_stack(int64_t size, MemoryType memory_type) {
     user_assert(size > 0) << "Allocation size should be a positive number\n";
+    switch (memory_type) {
+    case MemoryType::Stack:
+    case MemoryType::Register:
+        return true;
+    case MemoryType::Heap:
+    case MemoryType::PerTask:
+        return false;
+    case MemoryType::Auto:
+        break;
+    }
     return (size <= 1024 * 16);
 }
 
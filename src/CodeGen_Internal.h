@@ -47,9 +47,12 @@ llvm::Type *llvm_type_of(llvm::LLVMContext *context, Halide::Type t);
 bool function_takes_user_context(const std::string &name);
 
 /** Given a size (in bytes), return True if the allocation size can fit
- * on the stack; otherwise, return False. This routine asserts if size is
+ * on the stack; otherwise, return False. Allocations explicitly placed
+ * on the stack or in registers always fit (their size was checked
+ * against the stack limit during lowering), and heap or per-task
+ * allocations never do. This routine asserts if size is
  * non-positive. */
-bool can_allocation_fit_on_stack(int64_t size);
+bool can_allocation_fit_on_stack(int64_t size, MemoryType memory_type);
 
 /** Given a Halide Euclidean division/mod operation, define it in terms of
  * div_round_to_zero or mod_round_to_zero. */
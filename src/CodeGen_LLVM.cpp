@@ -12,6 +12,7 @@
 #include "Simplify.h"
 #include "JITModule.h"
 #include "CodeGen_Internal.h"
+#include "FixedPoint.h"
 #include "Lerp.h"
 #include "Util.h"
 #include "LLVM_Runtime_Linker.h"
@@ -1736,55 +1737,69 @@ void CodeGen_LLVM::visit(const Load *op) {
 
         if (ramp && stride && stride->value == 1) {
             value = codegen_dense_vector_load(op);
-        } else if (ramp && stride && stride->value == 2) {
-            // Load two vectors worth and then shuffle
-            Expr base_a = ramp->base, base_b = ramp->base + ramp->lanes;
-            Expr stride_a = make_one(base_a.type());
-            Expr stride_b = make_one(base_b.type());
-
-            // False indicates we should take the even-numbered lanes
-            // from the load, true indicates we should take the
-            // odd-numbered-lanes.
-            bool shifted_a = false, shifted_b = false;
-
+        } else if (ramp && stride && stride->value >= 2 && stride->value <= 4) {
+            // Load stride vectors worth of dense data and then
+            // shuffle out the lanes we want. We first try to align
+            // the base to the stride. This makes strided loads of
+            // neighbouring elements (e.g. the channels of interleaved
+            // rgb data) become identical dense loads, which llvm then
+            // shares.
+            int s = (int)stride->value;
+            int lanes = ramp->lanes;
+            Expr base = ramp->base;
+            int offset = 0;
+
+            // Rounding the base down reads up to s - 1 elements
+            // before the first one asked for. If the alignment info
+            // says the index is a known remainder mod the stride,
+            // that's still within the buffer. A constant offset in
+            // the base proves nothing of the sort, so we only use it
+            // for internal allocations, which halide_malloc gives a
+            // safety margin.
             bool external = op->param.defined() || op->image.defined();
-
-            // Don't read beyond the end of an external buffer.
-            if (external) {
-                base_b -= 1;
-                shifted_b = true;
-            } else {
-                // If the base ends in an odd constant, then subtract one
-                // and do a different shuffle. This helps expressions like
-                // (f(2*x) + f(2*x+1) share loads
-                const Add *add = ramp->base.as<Add>();
-                const IntImm *offset = add ? add->b.as<IntImm>() : nullptr;
-                if (offset && offset->value & 1) {
-                    base_a -= 1;
-                    shifted_a = true;
-                    base_b -= 1;
-                    shifted_b = true;
-                }
+            ModulusRemainder mod_rem = get_alignment_info(base);
+            const Add *add = base.as<Add>();
+            const IntImm *add_b = add ? add->b.as<IntImm>() : nullptr;
+            if ((mod_rem.modulus % s) == 0) {
+                offset = mod_imp(mod_rem.remainder, s);
+            } else if (add_b && !external) {
+                offset = (int)mod_imp(add_b->value, (int64_t)s);
+            }
+            if (offset) {
+                base = simplify(base - offset);
             }
 
+            // The dense loads end s - 1 - offset elements past the
+            // last one asked for. Shift the last load backwards so
+            // that we never read beyond the end of an external
+            // buffer, or beyond the one element of padding that
+            // internal allocations get (see
+            // CodeGen_Posix::allocation_padding).
+            int shift = external ? (s - 1 - offset) : std::max(s - 2 - offset, 0);
+
             // Do each load.
-            Expr ramp_a = Ramp::make(base_a, stride_a, ramp->lanes);
-            Expr ramp_b = Ramp::make(base_b, stride_b, ramp->lanes);
-            Expr load_a = Load::make(op->type, op->name, ramp_a, op->image, op->param, op->predicate);
-            Expr load_b = Load::make(op->type, op->name, ramp_b, op->image, op->param, op->predicate);
-            Value *vec_a = codegen(load_a);
-            Value *vec_b = codegen(load_b);
+            vector<Value *> loads;
+            for (int i = 0; i < s; i++) {
+                Expr load_base = base + i * lanes;
+                if (i == s - 1) {
+                    load_base -= shift;
+                }
+                Expr load_index = Ramp::make(simplify(load_base), make_one(base.type()), lanes);
+                Expr load = Load::make(op->type, op->name, load_index, op->image, op->param, op->predicate);
+                loads.push_back(codegen(load));
+            }
 
             // Shuffle together the results.
-            vector<int> indices(ramp->lanes);
-            for (int i = 0; i < (ramp->lanes + 1)/2; i++) {
-                indices[i] = i*2 + (shifted_a ? 1 : 0);
-            }
-            for (int i = (ramp->lanes + 1)/2; i < ramp->lanes; i++) {
-                indices[i] = i*2 + (shifted_b ? 1 : 0);
+            vector<int> indices(lanes);
+            for (int i = 0; i < lanes; i++) {
+                int idx = i * s + offset;
+                if (idx >= (s - 1) * lanes) {
+                    idx += shift;
+                }
+                indices[i] = idx;
             }
 
-            value = shuffle_vectors(vec_a, vec_b, indices);
+            value = shuffle_vectors(concat_vectors(loads), indices);
         } else if (ramp && stride && stride->value == -1) {
             // Load the vector and then flip it in-place
             Expr flipped_base = ramp->base - ramp->lanes + 1;
@@ -2341,6 +2356,8 @@ void CodeGen_LLVM::visit(const Call *op) {
     } else if (op->is_intrinsic(Call::lerp)) {
         internal_assert(op->args.size() == 3);
         value = codegen(lower_lerp(op->args[0], op->args[1], op->args[2]));
+    } else if (is_fixed_point_intrinsic(op)) {
+        value = codegen(lower_fixed_point_intrinsic(op));
     } else if (op->is_intrinsic(Call::popcount)) {
         internal_assert(op->args.size() == 1);
         std::vector<llvm::Type*> arg_type(1);
@@ -2722,6 +2739,13 @@ void CodeGen_LLVM::visit(const Call *op) {
 
         value = builder->CreateCall(prefetch_fn, args);
 
+    } else if (op->is_intrinsic(Call::nontemporal_stores)) {
+        for (Expr arg : op->args) {
+            const StringImm *buf = arg.as<StringImm>();
+            internal_assert(buf) << "nontemporal_stores takes buffer names\n";
+            nontemporal_buffers.insert(buf->value);
+        }
+        value = ConstantInt::get(i32_t, 0);
     } else if (op->is_intrinsic(Call::signed_integer_overflow)) {
         user_error << "Signed integer overflow occurred during constant-folding. Signed"
             " integer overflow for int32 and int64 is undefined behavior in"
@@ -2745,6 +2769,78 @@ void CodeGen_LLVM::visit(const Call *op) {
         internal_assert(op->args.size() == 1);
         Expr e = Internal::halide_exp(op->args[0]);
         e.accept(this);
+    } else if (op->call_type == Call::PureExtern && op->type.is_vector() &&
+               op->type.element_of() == Float(32) &&
+               (op->name == "sin_f32" || op->name == "cos_f32" ||
+                op->name == "tan_f32" || op->name == "asin_f32" ||
+                op->name == "acos_f32" || op->name == "atan_f32" ||
+                op->name == "atan2_f32")) {
+        // Use polynomial approximations instead of calling libm once
+        // per lane.
+        vector<string> names;
+        vector<Expr> args;
+        for (Expr arg : op->args) {
+            names.push_back(unique_name('t'));
+            sym_push(names.back(), codegen(arg));
+            args.push_back(Variable::make(arg.type(), names.back()));
+        }
+
+        Expr e;
+        if (op->name == "sin_f32") {
+            e = Internal::halide_sin(args[0]);
+        } else if (op->name == "cos_f32") {
+            e = Internal::halide_cos(args[0]);
+        } else if (op->name == "tan_f32") {
+            e = Internal::halide_tan(args[0]);
+        } else if (op->name == "asin_f32") {
+            e = Internal::halide_asin(args[0]);
+        } else if (op->name == "acos_f32") {
+            e = Internal::halide_acos(args[0]);
+        } else if (op->name == "atan_f32") {
+            e = Internal::halide_atan(args[0]);
+        } else {
+            internal_assert(args.size() == 2);
+            e = Internal::halide_atan2(args[0], args[1]);
+        }
+
+        if (op->name == "sin_f32" || op->name == "cos_f32" || op->name == "tan_f32") {
+            // The polynomials give NaN for arguments too large to
+            // range-reduce accurately, and for infinities and
+            // NaNs. If any lane has one, call libm for every lane
+            // instead.
+            Value *out_of_range = codegen(Internal::halide_trig_out_of_range(args[0]));
+            llvm::Type *mask_t = IntegerType::get(*context, op->type.lanes());
+            out_of_range = builder->CreateBitCast(out_of_range, mask_t);
+            Value *all_in_range = builder->CreateICmpEQ(out_of_range, ConstantInt::get(mask_t, 0));
+
+            BasicBlock *polynomial_bb = BasicBlock::Create(*context, "polynomial_bb", function);
+            BasicBlock *libm_bb = BasicBlock::Create(*context, "libm_bb", function);
+            BasicBlock *after_bb = BasicBlock::Create(*context, "after_bb", function);
+            builder->CreateCondBr(all_in_range, polynomial_bb, libm_bb, very_likely_branch);
+
+            builder->SetInsertPoint(polynomial_bb);
+            Value *polynomial_value = codegen(e);
+            builder->CreateBr(after_bb);
+            BasicBlock *polynomial_pred = builder->GetInsertBlock();
+
+            builder->SetInsertPoint(libm_bb);
+            scalarize(Call::make(op->type, op->name, args, op->call_type));
+            Value *libm_value = value;
+            builder->CreateBr(after_bb);
+            BasicBlock *libm_pred = builder->GetInsertBlock();
+
+            builder->SetInsertPoint(after_bb);
+            PHINode *phi = builder->CreatePHI(polynomial_value->getType(), 2);
+            phi->addIncoming(polynomial_value, polynomial_pred);
+            phi->addIncoming(libm_value, libm_pred);
+            value = phi;
+        } else {
+            value = codegen(e);
+        }
+
+        for (const string &name : names) {
+            sym_pop(name);
+        }
     } else if (op->call_type == Call::PureExtern &&
                (op->name == "is_nan_f32" || op->name == "is_nan_f64")) {
         internal_assert(op->args.size() == 1);
@@ -3019,7 +3115,15 @@ void CodeGen_LLVM::visit(const ProducerConsumer *op) {
     BasicBlock *produce = BasicBlock::Create(*context, name, function);
     builder->CreateBr(produce);
     builder->SetInsertPoint(produce);
+    std::set<std::string> old_nontemporal_buffers = nontemporal_buffers;
     codegen(op->body);
+    if (op->is_producer && nontemporal_buffers.size() > old_nontemporal_buffers.size()) {
+        // The body started with a nontemporal_stores marker for
+        // this Func. Its stores must be fenced before consumers
+        // read them.
+        fence_nontemporal_stores();
+        nontemporal_buffers.swap(old_nontemporal_buffers);
+    }
 }
 
 void CodeGen_LLVM::visit(const For *op) {
@@ -3128,8 +3232,18 @@ void CodeGen_LLVM::visit(const For *op) {
         unpack_closure(closure, symbol_table, closure_t, closure_handle, builder);
 
         // Generate the new function body
+        bool old_emitted_nontemporal_stores = emitted_nontemporal_stores;
+        emitted_nontemporal_stores = false;
         codegen(op->body);
 
+        // The task may run on a worker thread, so any streaming
+        // stores it made must be fenced on that thread before it
+        // reports completion.
+        if (emitted_nontemporal_stores) {
+            fence_nontemporal_stores();
+        }
+        emitted_nontemporal_stores = old_emitted_nontemporal_stores;
+
         // Return success
         return_with_error_code(ConstantInt::get(i32_t, 0));
 
@@ -3229,6 +3343,15 @@ void CodeGen_LLVM::visit(const Store *op) {
                 Value *vec_ptr = builder->CreatePointerCast(elt_ptr, slice_val->getType()->getPointerTo());
                 StoreInst *store = builder->CreateAlignedStore(slice_val, vec_ptr, alignment);
                 add_tbaa_metadata(store, op->name, slice_index);
+                if (slice_lanes > 1 &&
+                    alignment * 8 >= slice_lanes * value_type.bits() &&
+                    nontemporal_buffers.count(op->name)) {
+                    // Streaming stores are only worth it (and on x86
+                    // only possible) for aligned full vectors.
+                    llvm::Metadata *one = ConstantAsMetadata::get(ConstantInt::get(i32_t, 1));
+                    store->setMetadata(LLVMContext::MD_nontemporal, MDNode::get(*context, {one}));
+                    emitted_nontemporal_stores = true;
+                }
             }
         } else if (ramp) {
             Type ptr_type = value_type.element_of();
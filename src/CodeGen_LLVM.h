@@ -392,6 +392,11 @@ protected:
      * inject the appropriate target-specific cleanup code. */
     virtual void prepare_for_early_exit() {}
 
+    /** Called once a Func written with non-temporal stores has been
+     * computed, to make those stores visible to later loads. Targets
+     * that emit streaming stores should inject a store fence. */
+    virtual void fence_nontemporal_stores() {}
+
     /** Get the llvm type equivalent to the given halide type in the
      * current context. */
     llvm::Type *llvm_type_of(Type);
@@ -406,6 +411,15 @@ protected:
      * guarantee their alignment) */
     std::set<std::string> external_buffer;
 
+    /** Which buffers are currently being written with non-temporal
+     * stores. */
+    std::set<std::string> nontemporal_buffers;
+
+    /** Whether any non-temporal stores have been emitted into the
+     * current function. Parallel loop bodies fence them before
+     * returning. */
+    bool emitted_nontemporal_stores = false;
+
     /** The user_context argument. May be a constant null if the
      * function is being compiled without a user context. */
     llvm::Value *get_user_context() const;
@@ -32,6 +32,35 @@ CodeGen_X86::CodeGen_X86(Target t) : CodeGen_Posix(t) {
 
 namespace {
 
+bool has_avx512(const Target &t) {
+    return (t.has_feature(Target::AVX512) ||
+            t.has_feature(Target::AVX512_KNL) ||
+            t.has_feature(Target::AVX512_Skylake) ||
+            t.has_feature(Target::AVX512_Cannonlake));
+}
+
+// AVX512BW, which has the byte and word instructions, exists on
+// Skylake and Cannonlake.
+bool has_avx512bw(const Target &t) {
+    return (t.has_feature(Target::AVX512_Skylake) ||
+            t.has_feature(Target::AVX512_Cannonlake));
+}
+
+// With AVX-512, vector comparisons write to mask registers, and
+// selects on them are masked moves. LLVM legalizes these well at any
+// vector width, so there's no need to slice them up ourselves.
+bool use_mask_registers(const Target &t, Type elem) {
+    #if LLVM_VERSION >= 40
+    if (elem.bits() >= 32) {
+        return has_avx512(t);
+    } else {
+        return has_avx512bw(t);
+    }
+    #else
+    return false;
+    #endif
+}
+
 // i32(i16_a)*i32(i16_b) +/- i32(i16_c)*i32(i16_d) can be done by
 // interleaving a, c, and b, d, and then using pmaddwd. We
 // recognize it here, and implement it in the initial module.
@@ -89,7 +118,7 @@ void CodeGen_X86::visit(const Sub *op) {
 }
 
 void CodeGen_X86::visit(const GT *op) {
-    if (op->type.is_vector()) {
+    if (op->type.is_vector() && !use_mask_registers(target, op->a.type())) {
         // Non-native vector widths get legalized poorly by llvm. We
         // split it up ourselves.
 
@@ -124,7 +153,7 @@ void CodeGen_X86::visit(const GT *op) {
 }
 
 void CodeGen_X86::visit(const EQ *op) {
-    if (op->type.is_vector()) {
+    if (op->type.is_vector() && !use_mask_registers(target, op->a.type())) {
         // Non-native vector widths get legalized poorly by llvm. We
         // split it up ourselves.
 
@@ -172,7 +201,8 @@ void CodeGen_X86::visit(const NE *op) {
 }
 
 void CodeGen_X86::visit(const Select *op) {
-    if (op->condition.type().is_vector()) {
+    if (op->condition.type().is_vector() &&
+        !use_mask_registers(target, op->true_value.type())) {
         // LLVM handles selects on vector conditions much better at native width
         Value *cond = codegen(op->condition);
         Value *true_val = codegen(op->true_value);
@@ -207,6 +237,22 @@ void CodeGen_X86::visit(const Cast *op) {
         return;
     }
 
+    if (target.has_feature(Target::F16C) && target.has_feature(Target::AVX)) {
+        // Convert eight lanes at a time between half and single
+        // precision with vcvtph2ps and vcvtps2ph.
+        Type src = op->value.type(), dst = op->type;
+        if (dst.element_of() == Float(32) && src.element_of() == Float(16)) {
+            Expr bits = reinterpret(UInt(16, src.lanes()), op->value);
+            value = call_intrin(dst, 8, "llvm.x86.vcvtph2ps.256", {bits});
+            return;
+        } else if (dst.element_of() == Float(16) && src.element_of() == Float(32)) {
+            // Rounding mode 0 is round to nearest even.
+            value = call_intrin(UInt(16, dst.lanes()), 8, "llvm.x86.vcvtps2ph.256", {op->value, 0});
+            value = builder->CreateBitCast(value, llvm_type_of(dst));
+            return;
+        }
+    }
+
     vector<Expr> matches;
 
     struct Pattern {
@@ -219,6 +265,33 @@ void CodeGen_X86::visit(const Cast *op) {
     };
 
     static Pattern patterns[] = {
+        // Only use the avx512 versions if we have more lanes than
+        // fit in a ymm register. These are defined in x86_avx512.ll.
+        {Target::AVX512_Skylake, true, Int(8, 64), 33, "paddsbx64",
+         i8_sat(wild_i16x_ + wild_i16x_)},
+        {Target::AVX512_Skylake, true, Int(8, 64), 33, "psubsbx64",
+         i8_sat(wild_i16x_ - wild_i16x_)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "paddusbx64",
+         u8_sat(wild_u16x_ + wild_u16x_)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "psubusbx64",
+         u8(max(wild_i16x_ - wild_i16x_, 0))},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "paddswx32",
+         i16_sat(wild_i32x_ + wild_i32x_)},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "psubswx32",
+         i16_sat(wild_i32x_ - wild_i32x_)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "padduswx32",
+         u16_sat(wild_u32x_ + wild_u32x_)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "psubuswx32",
+         u16(max(wild_i32x_ - wild_i32x_, 0))},
+        {Target::AVX512_Skylake, true, Int(16, 32), 17, "pmulhwx32",
+         i16((wild_i32x_ * wild_i32x_) / 65536)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "pmulhuwx32",
+         u16((wild_u32x_ * wild_u32x_) / 65536)},
+        {Target::AVX512_Skylake, true, UInt(8, 64), 33, "pavgbx64",
+         u8(((wild_u16x_ + wild_u16x_) + 1) / 2)},
+        {Target::AVX512_Skylake, true, UInt(16, 32), 17, "pavgwx32",
+         u16(((wild_u32x_ + wild_u32x_) + 1) / 2)},
+
         {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.padds.b",
          i8_sat(wild_i16x_ + wild_i16x_)},
         {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.psubs.b",
@@ -263,7 +336,13 @@ void CodeGen_X86::visit(const Cast *op) {
     for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
         const Pattern &pattern = patterns[i];
 
-        if (!target.has_feature(pattern.feature)) {
+        if (pattern.feature == Target::AVX512_Skylake) {
+            // The avx512 patterns are only in the runtime for targets
+            // with AVX512BW.
+            if (LLVM_VERSION < 40 || !has_avx512bw(target)) {
+                continue;
+            }
+        } else if (!target.has_feature(pattern.feature)) {
             continue;
         }
 
@@ -404,11 +483,109 @@ void CodeGen_X86::visit(const Call *op) {
                           cast(wider, op->args[0]) <<
                           cast(wider, op->args[1]));
         codegen(equiv);
+    } else if (op->is_intrinsic(Call::rounding_mul_shift_right) &&
+               op->type.is_vector() &&
+               op->type.element_of() == Int(16) &&
+               is_const(op->args[2], 15) &&
+               target.has_feature(Target::SSE41)) {
+        // This is pmulhrsw (which is ssse3, so we use sse41 as a
+        // proxy), except that pmulhrsw wraps around to -32768 when
+        // both args are -32768 instead of saturating. Flipping all
+        // the bits of those lanes fixes it.
+        Value *result;
+        if (target.has_feature(Target::AVX2) && op->type.lanes() > 8) {
+            result = call_intrin(op->type, 16, "llvm.x86.avx2.pmul.hr.sw", {op->args[0], op->args[1]});
+        } else {
+            result = call_intrin(op->type, 8, "llvm.x86.ssse3.pmul.hr.sw.128", {op->args[0], op->args[1]});
+        }
+        Value *overflowed = builder->CreateICmpEQ(result, codegen(make_const(op->type, -32768)));
+        value = builder->CreateXor(result, builder->CreateSExt(overflowed, result->getType()));
     } else {
         CodeGen_Posix::visit(op);
     }
 }
 
+bool CodeGen_X86::use_gather_scatter(const string &name, Type t, Expr index, bool is_store) const {
+    #if LLVM_VERSION >= 40
+    // Hardware gathers and scatters only exist for 32 and 64-bit
+    // elements, and are only faster than inserting or extracting
+    // lanes one at a time when there are enough lanes.
+    if (t.is_handle() ||
+        (t.bits() != 32 && t.bits() != 64) ||
+        t.bits() * t.lanes() < 128) {
+        return false;
+    }
+
+    // Ramps with a constant stride are better done with dense loads
+    // and shuffles, or with strided scalar accesses.
+    const Ramp *ramp = index.as<Ramp>();
+    if (ramp && is_const(ramp->stride)) {
+        return false;
+    }
+
+    // A broadcast index is a single scalar load and a broadcast.
+    if (index.as<Broadcast>()) {
+        return false;
+    }
+
+    bool avx512 = has_avx512(target);
+    if (is_store) {
+        // Scatters can't be marked non-temporal. Leave stores to
+        // buffers scheduled with store_nontemporal to the general
+        // path.
+        if (nontemporal_buffers.count(name)) {
+            return false;
+        }
+        // Scatters are new in AVX-512.
+        return avx512;
+    } else {
+        return avx512 || target.has_feature(Target::AVX2);
+    }
+    #else
+    return false;
+    #endif
+}
+
+Value *CodeGen_X86::codegen_gather_scatter_pointers(const string &name, Type t, Expr index) {
+    // Leave the indices as 32-bit so that they map onto the
+    // dword-indexed forms of the instructions. The GEP sign-extends
+    // them.
+    Value *base = codegen_buffer_pointer(name, t.element_of(), ConstantInt::get(i32_t, 0));
+    return builder->CreateInBoundsGEP(base, codegen(index));
+}
+
+void CodeGen_X86::visit(const Load *op) {
+    if (!op->type.is_vector() || !use_gather_scatter(op->name, op->type, op->index, false)) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    Value *ptrs = codegen_gather_scatter_pointers(op->name, op->type, op->index);
+    Value *mask = is_one(op->predicate) ? nullptr : codegen(op->predicate);
+    Instruction *gather = builder->CreateMaskedGather(ptrs, op->type.bytes(), mask);
+    add_tbaa_metadata(gather, op->name, op->index);
+    value = gather;
+}
+
+void CodeGen_X86::visit(const Store *op) {
+    Type t = op->value.type();
+    if (!t.is_vector() || !use_gather_scatter(op->name, t, op->index, true)) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    Value *val = codegen(op->value);
+    Value *ptrs = codegen_gather_scatter_pointers(op->name, t, op->index);
+    Value *mask = is_one(op->predicate) ? nullptr : codegen(op->predicate);
+    Instruction *scatter = builder->CreateMaskedScatter(val, ptrs, t.bytes(), mask);
+    add_tbaa_metadata(scatter, op->name, op->index);
+}
+
+void CodeGen_X86::fence_nontemporal_stores() {
+    llvm::Function *sfence = Intrinsic::getDeclaration(module.get(), Intrinsic::x86_sse_sfence);
+    builder->CreateCall(sfence);
+}
+
 string CodeGen_X86::mcpu() const {
     #if LLVM_VERSION >= 40
     if (target.has_feature(Target::AVX512_Cannonlake)) return "cannonlake";
@@ -439,10 +616,7 @@ string CodeGen_X86::mattrs() const {
         separator = ",";
     }
     #if LLVM_VERSION >= 40
-    if (target.has_feature(Target::AVX512) ||
-        target.has_feature(Target::AVX512_KNL) ||
-        target.has_feature(Target::AVX512_Skylake) ||
-        target.has_feature(Target::AVX512_Cannonlake)) {
+    if (has_avx512(target)) {
         features += separator + "+avx512f,+avx512cd";
         separator = ",";
         if (target.has_feature(Target::AVX512_KNL)) {
@@ -465,10 +639,7 @@ bool CodeGen_X86::use_soft_float_abi() const {
 }
 
 int CodeGen_X86::native_vector_bits() const {
-    if (target.has_feature(Target::AVX512) ||
-        target.has_feature(Target::AVX512_Skylake) ||
-        target.has_feature(Target::AVX512_KNL) ||
-        target.has_feature(Target::AVX512_Cannonlake)) {
+    if (has_avx512(target)) {
         return 512;
     } else if (target.has_feature(Target::AVX) ||
                target.has_feature(Target::AVX2)) {
@@ -31,6 +31,18 @@ protected:
 
     Expr mulhi_shr(Expr a, Expr b, int shr);
 
+    /** Streaming stores are weakly ordered, so follow them with an
+     * sfence. */
+    void fence_nontemporal_stores();
+
+    /** Should a vector load or store of the given type at the given
+     * index into the named buffer use a hardware gather or scatter? */
+    bool use_gather_scatter(const std::string &name, Type t, Expr index, bool is_store) const;
+
+    /** Compute the vector of addresses accessed by a gather or
+     * scatter. */
+    llvm::Value *codegen_gather_scatter_pointers(const std::string &name, Type t, Expr index);
+
     using CodeGen_Posix::visit;
 
     /** Nodes for which we want to emit specific sse/avx intrinsics */
@@ -48,6 +60,8 @@ protected:
     void visit(const EQ *);
     void visit(const NE *);
     void visit(const Select *);
+    void visit(const Load *);
+    void visit(const Store *);
     // @}
 };
 
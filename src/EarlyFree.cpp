@@ -162,7 +162,7 @@ class InjectEarlyFrees : public IRMutator {
         } else {
             stmt = Allocate::make(alloc->name, alloc->type, alloc->extents, alloc->condition,
                                   Block::make(alloc->body, make_free(alloc->name, last_use.found_device_malloc)),
-                                  alloc->new_expr);
+                                  alloc->new_expr, std::string(), alloc->memory_type);
         }
 
     }
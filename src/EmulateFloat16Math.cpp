@@ -0,0 +1,177 @@
+#include "EmulateFloat16Math.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+Expr bfloat16_to_float32(Expr e) {
+    internal_assert(e.type().is_bfloat() && e.type().bits() == 16);
+    int lanes = e.type().lanes();
+    // A bfloat16 is the top half of a float32.
+    Expr bits = cast(UInt(32, lanes), reinterpret(UInt(16, lanes), e));
+    return reinterpret(Float(32, lanes), bits << 16);
+}
+
+Expr float32_to_bfloat16(Expr e) {
+    internal_assert(e.type() == Float(32, e.type().lanes()));
+    int lanes = e.type().lanes();
+    Type u32 = UInt(32, lanes);
+    Expr bits = reinterpret(u32, e);
+    // Round to nearest, ties to even, by adding just under half of
+    // the dropped bits, plus the lowest kept bit.
+    Expr rounded = (bits + (make_const(u32, 0x7fff) + ((bits >> 16) & make_one(u32)))) >> 16;
+    // Adding could carry a NaN into infinity, so handle NaNs separately,
+    // keeping them NaN and making them quiet.
+    Expr nan = (bits & make_const(u32, 0x7fffffff)) > make_const(u32, 0x7f800000);
+    Expr result = select(nan, (bits >> 16) | make_const(u32, 0x40), rounded);
+    return reinterpret(BFloat(16, lanes), cast(UInt(16, lanes), result));
+}
+
+namespace {
+
+class EmulateFloat16Math : public IRMutator {
+    using IRMutator::visit;
+
+    bool native_float16;
+
+    bool is_emulated(Type t) {
+        return (t.is_bfloat() ||
+                (t.is_float() && t.bits() == 16 && !native_float16));
+    }
+
+    Expr widen(Expr e) {
+        if (e.type().is_bfloat()) {
+            return bfloat16_to_float32(e);
+        } else if (is_emulated(e.type())) {
+            return Cast::make(Float(32, e.type().lanes()), e);
+        } else {
+            return e;
+        }
+    }
+
+    Expr narrow(Expr e, Type t) {
+        internal_assert(e.type() == Float(32, t.lanes()));
+        if (t.is_bfloat()) {
+            return float32_to_bfloat16(e);
+        } else {
+            return Cast::make(t, e);
+        }
+    }
+
+    template<typename T>
+    void visit_binary_operator(const T *op) {
+        if (is_emulated(op->a.type())) {
+            Expr a = widen(mutate(op->a));
+            Expr b = widen(mutate(op->b));
+            expr = T::make(a, b);
+            if (op->type.is_float()) {
+                expr = narrow(expr, op->type);
+            }
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Add *op) {visit_binary_operator(op);}
+    void visit(const Sub *op) {visit_binary_operator(op);}
+    void visit(const Mul *op) {visit_binary_operator(op);}
+    void visit(const Div *op) {visit_binary_operator(op);}
+    void visit(const Mod *op) {visit_binary_operator(op);}
+    void visit(const Min *op) {visit_binary_operator(op);}
+    void visit(const Max *op) {visit_binary_operator(op);}
+    void visit(const EQ *op) {visit_binary_operator(op);}
+    void visit(const NE *op) {visit_binary_operator(op);}
+    void visit(const LT *op) {visit_binary_operator(op);}
+    void visit(const LE *op) {visit_binary_operator(op);}
+    void visit(const GT *op) {visit_binary_operator(op);}
+    void visit(const GE *op) {visit_binary_operator(op);}
+
+    void visit(const Cast *op) {
+        Type src = op->value.type(), dst = op->type;
+        if (!src.is_bfloat() && !dst.is_bfloat()) {
+            IRMutator::visit(op);
+            return;
+        }
+        // Go via Float(32), which can represent every bfloat16 exactly.
+        Expr value = mutate(op->value);
+        Type f32 = Float(32, dst.lanes());
+        if (src.is_bfloat()) {
+            value = bfloat16_to_float32(value);
+        } else if (src != f32) {
+            value = Cast::make(f32, value);
+        }
+        if (dst.is_bfloat()) {
+            expr = float32_to_bfloat16(value);
+        } else if (dst != f32) {
+            expr = Cast::make(dst, value);
+        } else {
+            expr = value;
+        }
+    }
+
+    void visit(const FloatImm *op) {
+        if (op->type.is_bfloat()) {
+            uint16_t bits = bfloat16_t(op->value).to_bits();
+            expr = reinterpret(op->type, make_const(UInt(16), bits));
+        } else {
+            expr = op;
+        }
+    }
+
+    void visit(const Call *op) {
+        // No backend has 16-bit versions of the math library, so
+        // calls to them are always done in Float(32).
+        const string suffix = "_f16";
+        if (op->call_type == Call::PureExtern &&
+            op->name.size() > suffix.size() &&
+            op->name.compare(op->name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            vector<Expr> args;
+            for (Expr arg : op->args) {
+                arg = mutate(arg);
+                if (arg.type().is_float() && arg.type().bits() == 16) {
+                    arg = Cast::make(Float(32, arg.type().lanes()), arg);
+                }
+                args.push_back(arg);
+            }
+            string name = op->name.substr(0, op->name.size() - suffix.size()) + "_f32";
+            if (op->type.is_float()) {
+                Type t = Float(32, op->type.lanes());
+                expr = Call::make(t, name, args, op->call_type);
+                expr = Cast::make(op->type, expr);
+            } else {
+                expr = Call::make(op->type, name, args, op->call_type);
+            }
+        } else if ((op->is_intrinsic(Call::abs) ||
+                    op->is_intrinsic(Call::absd) ||
+                    op->is_intrinsic(Call::lerp)) &&
+                   is_emulated(op->type)) {
+            vector<Expr> args;
+            for (Expr arg : op->args) {
+                args.push_back(widen(mutate(arg)));
+            }
+            expr = Call::make(Float(32, op->type.lanes()), op->name, args, op->call_type);
+            expr = narrow(expr, op->type);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    EmulateFloat16Math(const Target &t) {
+        native_float16 = (t.arch == Target::ARM && t.bits == 64 &&
+                          t.has_feature(Target::ARMFp16));
+    }
+};
+
+}
+
+Stmt emulate_float16_math(Stmt s, const Target &t) {
+    return EmulateFloat16Math(t).mutate(s);
+}
+
+}
+}
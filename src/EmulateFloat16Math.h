@@ -0,0 +1,36 @@
+#ifndef HALIDE_EMULATE_FLOAT16_MATH_H
+#define HALIDE_EMULATE_FLOAT16_MATH_H
+
+/** \file
+ * Defines the lowering pass that does 16-bit floating point math in
+ * 32-bit floats.
+ */
+
+#include "IR.h"
+#include "Target.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Rewrite arithmetic, comparisons, and math library calls on
+ * BFloat(16) values to be done in Float(32), and lower conversions to
+ * and from BFloat(16) to integer operations, which vectorize on every
+ * target. Do the same for Float(16) arithmetic unless the target has
+ * native half-precision arithmetic (ARMFp16 on 64-bit ARM). Casts
+ * between Float(16) and Float(32) are left for the backends, which
+ * have vector instructions for them on most targets. After this pass,
+ * BFloat(16) values are only loaded, stored, moved, and
+ * reinterpreted. */
+Stmt emulate_float16_math(Stmt s, const Target &t);
+
+/** Convert a BFloat(16) expression to Float(32). This is exact. */
+Expr bfloat16_to_float32(Expr e);
+
+/** Convert a Float(32) expression to BFloat(16), rounding to
+ * nearest, ties to even. */
+Expr float32_to_bfloat16(Expr e);
+
+}
+}
+
+#endif
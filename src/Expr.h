@@ -222,6 +222,11 @@ struct FloatImm : public ExprNode<FloatImm> {
             << "FloatImm must be a scalar Float\n";
         FloatImm *node = new FloatImm;
         node->type = t;
+        if (t.is_bfloat()) {
+            internal_assert(t.bits() == 16) << "BFloat must be 16-bit\n";
+            node->value = (double)((bfloat16_t)value);
+            return node;
+        }
         switch (t.bits()) {
         case 16:
             node->value = (double)((float16_t)value);
@@ -280,6 +285,7 @@ struct Expr : public Internal::IRHandle {
     EXPORT explicit Expr(uint32_t x)  : IRHandle(Internal::UIntImm::make(UInt(32), x)) {}
     EXPORT explicit Expr(uint64_t x)  : IRHandle(Internal::UIntImm::make(UInt(64), x)) {}
     EXPORT          Expr(float16_t x) : IRHandle(Internal::FloatImm::make(Float(16), (double)x)) {}
+    EXPORT          Expr(bfloat16_t x) : IRHandle(Internal::FloatImm::make(BFloat(16), (double)x)) {}
     EXPORT          Expr(float x)     : IRHandle(Internal::FloatImm::make(Float(32), x)) {}
     EXPORT explicit Expr(double x)    : IRHandle(Internal::FloatImm::make(Float(64), x)) {}
     // @}
@@ -327,6 +333,34 @@ const DeviceAPI all_device_apis[] = {DeviceAPI::None,
                                      DeviceAPI::Metal,
                                      DeviceAPI::Hexagon};
 
+/** An enum describing where a Func's storage should be placed. Used by
+ * schedules, and in the Allocate IR node. */
+enum class MemoryType {
+    /** Let Halide decide. Small constant-sized allocations go on the
+     * stack, and everything else goes on the heap. */
+    Auto,
+
+    /** Always allocate with halide_malloc. */
+    Heap,
+
+    /** Always allocate on the stack. The size must be bounded by a
+     * constant, which may not exceed the stack allocation limit. */
+    Stack,
+
+    /** Keep the values in registers. Like Stack, but additionally
+     * every access must have a constant index once loops have been
+     * unrolled and vectorized, so that the allocation can be promoted
+     * to SSA values. */
+    Register,
+
+    /** Allocate on the heap once per task, and reuse the allocation
+     * for every iteration of the serial loops within that task. A
+     * task is one iteration of the innermost enclosing parallel loop,
+     * or the whole pipeline outside of parallel loops. The allocation
+     * is sized for the largest iteration. */
+    PerTask
+};
+
 namespace Internal {
 
 /** An enum describing a type of loop traversal. Used in schedules, and in
@@ -0,0 +1,99 @@
+#include "FixedPoint.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+Type widen(Type t) {
+    return t.with_bits(t.bits() * 2);
+}
+
+// Shift x right by a shift of the same type, rounding to nearest. The
+// rounding bit is the last bit shifted out, which avoids an addition
+// that could overflow.
+Expr shift_right_rounding(Expr x, Expr shift) {
+    Type t = x.type();
+    Expr one = make_one(t);
+    const int64_t *ci = as_const_int(shift);
+    const uint64_t *cu = as_const_uint(shift);
+    if (ci || cu) {
+        uint64_t c = ci ? (uint64_t)(*ci) : *cu;
+        if (c == 0) {
+            return x;
+        }
+        return (x >> shift) + ((x >> make_const(t, c - 1)) & one);
+    } else {
+        return select(shift > make_zero(t),
+                      (x >> shift) + ((x >> (shift - one)) & one),
+                      x);
+    }
+}
+
+}
+
+bool is_fixed_point_intrinsic(const Call *op) {
+    return (op->is_intrinsic(Call::widening_add) ||
+            op->is_intrinsic(Call::widening_mul) ||
+            op->is_intrinsic(Call::saturating_add) ||
+            op->is_intrinsic(Call::saturating_sub) ||
+            op->is_intrinsic(Call::halving_add) ||
+            op->is_intrinsic(Call::rounding_halving_add) ||
+            op->is_intrinsic(Call::rounding_shift_right) ||
+            op->is_intrinsic(Call::rounding_mul_shift_right));
+}
+
+Expr lower_fixed_point_intrinsic(const Call *op) {
+    internal_assert(is_fixed_point_intrinsic(op));
+    internal_assert(op->args.size() >= 2);
+
+    Type t = op->type;
+    Expr a = op->args[0];
+    Expr b = op->args[1];
+    Type w = widen(a.type());
+
+    if (op->is_intrinsic(Call::widening_add)) {
+        return cast(w, a) + cast(w, b);
+    } else if (op->is_intrinsic(Call::widening_mul)) {
+        return cast(w, a) * cast(w, b);
+    } else if (op->is_intrinsic(Call::saturating_add)) {
+        return saturating_cast(t, cast(w, a) + cast(w, b));
+    } else if (op->is_intrinsic(Call::saturating_sub)) {
+        if (t.is_uint()) {
+            // Do the subtraction in a wider signed type, so that
+            // we only need to clamp the bottom end.
+            Type ws = Int(t.bits() * 2, t.lanes());
+            return cast(t, max(cast(ws, a) - cast(ws, b), 0));
+        } else {
+            return saturating_cast(t, cast(w, a) - cast(w, b));
+        }
+    } else if (op->is_intrinsic(Call::halving_add)) {
+        return cast(t, (cast(w, a) + cast(w, b)) / 2);
+    } else if (op->is_intrinsic(Call::rounding_halving_add)) {
+        return cast(t, ((cast(w, a) + cast(w, b)) + 1) / 2);
+    } else if (op->is_intrinsic(Call::rounding_shift_right)) {
+        return shift_right_rounding(a, cast(t, b));
+    } else if (op->is_intrinsic(Call::rounding_mul_shift_right)) {
+        internal_assert(op->args.size() == 3);
+        Expr q = op->args[2];
+        Expr product = cast(w, a) * cast(w, b);
+        const uint64_t *c = as_const_uint(q);
+        if (c && *c > 0 && *c <= (uint64_t)t.bits()) {
+            // The rounding term can't overflow, so use the
+            // add-then-divide form that the backends recognize
+            // (e.g. as vqrdmulh on ARM).
+            Expr round = make_const(w, (int64_t)1 << (*c - 1));
+            Expr divisor = make_const(w, (int64_t)1 << *c);
+            return saturating_cast(t, (product + round) / divisor);
+        } else {
+            return saturating_cast(t, shift_right_rounding(product, cast(w, q)));
+        }
+    }
+
+    internal_error << "Unhandled fixed-point intrinsic: " << op->name << "\n";
+    return Expr();
+}
+
+}
+}
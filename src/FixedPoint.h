@@ -0,0 +1,28 @@
+#ifndef HALIDE_FIXED_POINT_H
+#define HALIDE_FIXED_POINT_H
+
+/** \file
+ * Defines methods for converting the fixed-point arithmetic
+ * intrinsics (saturating_add, rounding_mul_shift_right, etc) into
+ * Halide IR.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Check if a call is one of the fixed-point arithmetic intrinsics. */
+bool EXPORT is_fixed_point_intrinsic(const Call *op);
+
+/** Build Halide IR that computes a fixed-point intrinsic using
+ * wider arithmetic. The result is in the form that the instruction
+ * selection in the x86 and ARM backends recognizes, so targets that
+ * have a native instruction for the operation still get it. Use by
+ * codegen targets that don't handle an intrinsic directly. */
+Expr EXPORT lower_fixed_point_intrinsic(const Call *op);
+
+}
+}
+
+#endif
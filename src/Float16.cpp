@@ -2,6 +2,9 @@
 #include "Error.h"
 #include "LLVM_Headers.h"
 
+#include <cmath>
+#include <string.h>
+
 using namespace Halide;
 
 // These helper functions are not members of float16_t because
@@ -366,4 +369,78 @@ uint16_t float16_t::to_bits() const {
     return this->data;
 }
 
+namespace {
+uint16_t float_to_bfloat16_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        // Keep NaNs NaN (and quiet), rather than letting the
+        // rounding below carry them into infinity.
+        return (uint16_t)((bits >> 16) | 0x40);
+    }
+    // Round to nearest, ties to even.
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return (uint16_t)(bits >> 16);
+}
+}
+
+bfloat16_t::bfloat16_t(float value) {
+    static_assert(sizeof(bfloat16_t) == 2, "bfloat16_t is wrong size");
+    this->data = float_to_bfloat16_bits(value);
+}
+
+bfloat16_t::bfloat16_t(double value) {
+    float f = (float)value;
+    if ((double)f != value && !std::isinf(f) && !std::isnan(f)) {
+        // Rounding twice (to float, then to bfloat16) can round
+        // incorrectly when the first rounding produces a tie. Round to
+        // float towards zero and set the sticky bit instead, which makes
+        // the second rounding correct.
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        if (std::abs((double)f) > std::abs(value)) {
+            bits--;
+        }
+        bits |= 1;
+        memcpy(&f, &bits, sizeof(bits));
+    }
+    this->data = float_to_bfloat16_bits(f);
+}
+
+bfloat16_t::bfloat16_t() : data(0) {
+}
+
+bfloat16_t::operator float() const {
+    uint32_t bits = (uint32_t)data << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bfloat16_t::operator double() const {
+    return (double)(float)(*this);
+}
+
+bfloat16_t bfloat16_t::make_from_bits(uint16_t bits) {
+    bfloat16_t val;
+    val.data = bits;
+    return val;
+}
+
+bool bfloat16_t::operator==(bfloat16_t rhs) const {
+    return (float)(*this) == (float)rhs;
+}
+
+bool bfloat16_t::operator<(bfloat16_t rhs) const {
+    return (float)(*this) < (float)rhs;
+}
+
+bool bfloat16_t::is_nan() const {
+    return (data & 0x7fff) > 0x7f80;
+}
+
+uint16_t bfloat16_t::to_bits() const {
+    return this->data;
+}
+
 }  // namespace halide
@@ -198,6 +198,61 @@ private:
     // this data type is 16-bits wide.
     uint16_t data;
 };
+
+/** Class that provides a type that implements bfloat16: the upper
+ *  16 bits of an IEEE754 binary32. It has the same exponent range as
+ *  a float, but only 7 bits of mantissa. Like float16_t, it holds
+ *  nothing but the raw bits, so it can be used as the element type
+ *  of a Buffer.
+ *
+ *  Conversions from float and double round to nearest, ties to even,
+ *  and preserve NaNs. Unlike float16_t they are silent when inexact,
+ *  like a conversion from double to float.
+ * */
+struct bfloat16_t {
+    /// \name Constructors
+    /// @{
+
+    /** Construct from a float, rounding to nearest, ties to even. */
+    EXPORT explicit bfloat16_t(float value);
+
+    /** Construct from a double, rounding to nearest, ties to even. */
+    EXPORT explicit bfloat16_t(double value);
+
+    /** Construct a bfloat16_t with the bits initialised to 0. This
+     * represents positive zero. */
+    EXPORT bfloat16_t();
+
+    /// @}
+
+    /** Cast to float. This is exact. */
+    EXPORT explicit operator float() const;
+    /** Cast to double. This is exact. */
+    EXPORT explicit operator double() const;
+
+    /** Get a new bfloat16_t with the given raw bits */
+    EXPORT static bfloat16_t make_from_bits(uint16_t bits);
+
+    /** \name Comparison operators
+     * These compare the values as floats, so NaN is not equal to
+     * anything, and positive and negative zero are equal. */
+    /**@{*/
+    EXPORT bool operator==(bfloat16_t rhs) const;
+    EXPORT bool operator!=(bfloat16_t rhs) const { return !(*this == rhs); }
+    EXPORT bool operator<(bfloat16_t rhs) const;
+    EXPORT bool operator>(bfloat16_t rhs) const { return rhs < *this; }
+    /**@}*/
+
+    EXPORT bool is_nan() const;
+
+    /** Returns the bits that represent this bfloat16_t. */
+    EXPORT uint16_t to_bits() const;
+
+private:
+    // The raw bits. This must be the only data member.
+    uint16_t data;
+};
+
 }  // namespace Halide
 
 template<>
@@ -205,4 +260,9 @@ HALIDE_ALWAYS_INLINE inline halide_type_t halide_type_of<Halide::float16_t>() {
     return halide_type_t(halide_type_float, 16);
 }
 
+template<>
+HALIDE_ALWAYS_INLINE inline halide_type_t halide_type_of<Halide::bfloat16_t>() {
+    return halide_type_t(halide_type_bfloat, 16);
+}
+
 #endif
@@ -827,7 +827,7 @@ Func Stage::rfactor(vector<pair<RVar, Var>> preserved) {
         const auto iter = std::find_if(dims.begin(), dims.end(),
             [&v](const Dim& dim) { return var_name_match(dim.var, v.name()); });
         if (iter == dims.end()) {
-            Dim d = {v.name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar};
+            Dim d = {v.name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar, false};
             dims.insert(dims.end()-1, d);
         }
     }
@@ -926,6 +926,7 @@ void Stage::split(const string &old, const string &outer, const string &inner, E
             outer_name = old_name + "." + outer;
             dims.insert(dims.begin() + i, dims[i]);
             dims[i].var = inner_name;
+            dims[i].per_strip_storage = false;
             dims[i+1].var = outer_name;
         }
     }
@@ -995,9 +996,10 @@ void Stage::split(const string &old, const string &outer, const string &inner, E
     }
 
     if (exact) {
-        user_assert(tail == TailStrategy::GuardWithIf)
+        user_assert(tail == TailStrategy::GuardWithIf ||
+                    tail == TailStrategy::Predicate)
             << "When splitting Var " << old_name
-            << " the tail strategy must be GuardWithIf or Auto. "
+            << " the tail strategy must be GuardWithIf, Predicate, or Auto. "
             << "Anything else may change the meaning of the algorithm\n";
     }
 
@@ -1390,6 +1392,27 @@ Stage &Stage::parallel(VarOrRVar var, Expr factor, TailStrategy tail) {
     return *this;
 }
 
+Stage &Stage::parallel_strips(VarOrRVar var, Expr strip_size, TailStrategy tail) {
+    string strip_name;
+    if (var.is_rvar) {
+        RVar tmp;
+        split(var.rvar, tmp, var.rvar, strip_size, tail);
+        parallel(tmp);
+        strip_name = tmp.name();
+    } else {
+        Var tmp;
+        split(var.var, tmp, var.var, strip_size, tail);
+        parallel(tmp);
+        strip_name = tmp.name();
+    }
+    for (Dim &d : definition.schedule().dims()) {
+        if (var_name_match(d.var, strip_name)) {
+            d.per_strip_storage = true;
+        }
+    }
+    return *this;
+}
+
 Stage &Stage::vectorize(VarOrRVar var, int factor, TailStrategy tail) {
     if (var.is_rvar) {
         RVar tmp;
@@ -1417,6 +1440,53 @@ Stage &Stage::unroll(VarOrRVar var, int factor, TailStrategy tail) {
     return *this;
 }
 
+Stage &Stage::unroll_and_jam(VarOrRVar var, int factor, TailStrategy tail) {
+    if (tail == TailStrategy::Auto && !var.is_rvar && !definition.is_init()) {
+        // Split would round up, which makes an update stage write
+        // outside of the region its Func is realized over. Guard the
+        // tail instead.
+        tail = TailStrategy::GuardWithIf;
+    }
+
+    string inner_name;
+    if (var.is_rvar) {
+        RVar tmp;
+        split(var.rvar, var.rvar, tmp, factor, tail);
+        inner_name = tmp.name();
+    } else {
+        Var tmp;
+        split(var.var, var.var, tmp, factor, tail);
+        inner_name = tmp.name();
+    }
+
+    // Move the unrolled copies inwards so that they become adjacent
+    // in the innermost loop body. They go just outside any vectorized
+    // loop, so that each copy is a whole vector.
+    vector<Dim> &dims = definition.schedule().dims();
+    size_t idx = 0;
+    while (idx < dims.size() && !var_name_match(dims[idx].var, inner_name)) {
+        idx++;
+    }
+    internal_assert(idx < dims.size());
+    size_t dest = 0;
+    while (dest < idx && dims[dest].for_type == ForType::Vectorized) {
+        dest++;
+    }
+    if (!dims[idx].is_pure()) {
+        for (size_t i = dest; i < idx; i++) {
+            user_assert(dims[i].is_pure())
+                << "In schedule for " << stage_name
+                << ", can't unroll and jam " << var.name()
+                << " inside of " << dims[i].var
+                << " because it may change the meaning of the algorithm.\n";
+        }
+    }
+    std::rotate(dims.begin() + dest, dims.begin() + idx, dims.begin() + idx + 1);
+
+    set_dim_type(VarOrRVar(inner_name, var.is_rvar), ForType::Unrolled);
+    return *this;
+}
+
 Stage &Stage::tile(VarOrRVar x, VarOrRVar y,
                    VarOrRVar xo, VarOrRVar yo,
                    VarOrRVar xi, VarOrRVar yi,
@@ -1860,6 +1930,18 @@ Func &Func::memoize() {
     return *this;
 }
 
+Func &Func::store_nontemporal() {
+    invalidate_cache();
+    func.schedule().store_nontemporal() = true;
+    return *this;
+}
+
+Func &Func::store_in(MemoryType t) {
+    invalidate_cache();
+    func.schedule().memory_type() = t;
+    return *this;
+}
+
 Stage Func::specialize(Expr c) {
     invalidate_cache();
     return Stage(func.definition(), name(), args(), func.schedule().storage_dims()).specialize(c);
@@ -1895,6 +1977,12 @@ Func &Func::parallel(VarOrRVar var, Expr factor, TailStrategy tail) {
     return *this;
 }
 
+Func &Func::parallel_strips(VarOrRVar var, Expr strip_size, TailStrategy tail) {
+    invalidate_cache();
+    Stage(func.definition(), name(), args(), func.schedule().storage_dims()).parallel_strips(var, strip_size, tail);
+    return *this;
+}
+
 Func &Func::vectorize(VarOrRVar var, int factor, TailStrategy tail) {
     invalidate_cache();
     Stage(func.definition(), name(), args(), func.schedule().storage_dims()).vectorize(var, factor, tail);
@@ -1907,6 +1995,12 @@ Func &Func::unroll(VarOrRVar var, int factor, TailStrategy tail) {
     return *this;
 }
 
+Func &Func::unroll_and_jam(VarOrRVar var, int factor, TailStrategy tail) {
+    invalidate_cache();
+    Stage(func.definition(), name(), args(), func.schedule().storage_dims()).unroll_and_jam(var, factor, tail);
+    return *this;
+}
+
 Func &Func::bound(Var var, Expr min, Expr extent) {
     user_assert(!min.defined() || Int(32).can_represent(min.type())) << "Can't represent min bound in int32\n";
     user_assert(extent.defined()) << "Extent bound of a Func can't be undefined\n";
@@ -2882,6 +2976,10 @@ void Func::set_custom_allocator(void *(*cust_malloc)(void *, size_t),
     pipeline().set_custom_allocator(cust_malloc, cust_free);
 }
 
+void Func::set_scratch_memory(Runtime::ScratchMemory *scratch) {
+    pipeline().set_scratch_memory(scratch);
+}
+
 void Func::set_custom_do_par_for(int (*cust_do_par_for)(void *, int (*)(void *, int, uint8_t *), int, int, uint8_t *)) {
     pipeline().set_custom_do_par_for(cust_do_par_for);
 }
@@ -2918,6 +3016,10 @@ void Func::realize(Realization dst, const Target &target) {
     pipeline().realize(dst, target);
 }
 
+MemoryFootprint Func::memory_footprint(Realization dst, const Target &target) {
+    return pipeline().memory_footprint(dst, target);
+}
+
 void Func::infer_input_bounds(Realization dst) {
     pipeline().infer_input_bounds(dst);
 }
@@ -179,8 +179,10 @@ public:
     EXPORT Stage &vectorize(VarOrRVar var);
     EXPORT Stage &unroll(VarOrRVar var);
     EXPORT Stage &parallel(VarOrRVar var, Expr task_size, TailStrategy tail = TailStrategy::Auto);
+    EXPORT Stage &parallel_strips(VarOrRVar var, Expr strip_size, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &vectorize(VarOrRVar var, int factor, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &unroll(VarOrRVar var, int factor, TailStrategy tail = TailStrategy::Auto);
+    EXPORT Stage &unroll_and_jam(VarOrRVar var, int factor, TailStrategy tail = TailStrategy::Auto);
     EXPORT Stage &tile(VarOrRVar x, VarOrRVar y,
                        VarOrRVar xo, VarOrRVar yo,
                        VarOrRVar xi, VarOrRVar yi, Expr
@@ -582,6 +584,11 @@ public:
      * automatically copy data back from the GPU. */
     EXPORT void realize(Realization dst, const Target &target = Target());
 
+    /** Get upper bounds on the memory that realizing this function
+     * into the given buffers would use, without running it. See
+     * Pipeline::memory_footprint. */
+    EXPORT MemoryFootprint memory_footprint(Realization dst, const Target &target = Target());
+
     /** For a given size of output, or a given output buffer,
      * determine the bounds required of all unbound ImageParams
      * referenced. Communicates the result by allocating new buffers
@@ -747,6 +754,11 @@ public:
     EXPORT void set_custom_allocator(void *(*malloc)(void *, size_t),
                                      void (*free)(void *, void *));
 
+    /** Allocate the heap memory for intermediate Funcs from the given
+     * ScratchMemory, so that repeated realizations reuse it. See
+     * Pipeline::set_scratch_memory. */
+    EXPORT void set_scratch_memory(Runtime::ScratchMemory *scratch);
+
     /** Set a custom task handler to be called by the parallel for
      * loop. It is useful to set this if you want to do some
      * additional bookkeeping at the granularity of parallel
@@ -1123,6 +1135,29 @@ public:
      * manually. */
     EXPORT Func &parallel(VarOrRVar var, Expr task_size, TailStrategy tail = TailStrategy::Auto);
 
+    /** Split a dimension into strips of size strip_size, and
+     * traverse the strips in parallel. After this call, var refers to
+     * the inner, serial dimension within each strip. The outer
+     * dimension has a new anonymous name. Funcs that are computed at
+     * or within var, but stored outside of the strips (e.g. with
+     * store_root), are given separate storage per strip. This means
+     * sliding window optimization and storage folding still apply
+     * within each strip: every strip computes its warm-up region
+     * once, then slides serially. E.g:
+     *
+     \code
+     Func f, g;
+     f(x, y) = ...;
+     g(x, y) = f(x, y-1) + f(x, y) + f(x, y+1);
+     g.parallel_strips(y, 64);
+     f.store_root().compute_at(g, y);
+     \endcode
+     *
+     * computes each row of f once, except for the two rows of
+     * overlap at the top of each strip of 64 rows of g.
+     */
+    EXPORT Func &parallel_strips(VarOrRVar var, Expr strip_size, TailStrategy tail = TailStrategy::Auto);
+
     /** Mark a dimension to be computed all-at-once as a single
      * vector. The dimension should have constant extent -
      * e.g. because it is the inner dimension following a split by a
@@ -1150,6 +1185,21 @@ public:
      * dimension of the split. */
     EXPORT Func &unroll(VarOrRVar var, int factor, TailStrategy tail = TailStrategy::Auto);
 
+    /** Split a dimension by the given factor, unroll the inner
+     * dimension, and move it to the innermost position (just outside
+     * any vectorized dimension). The unrolled copies of the loop body
+     * then sit next to each other inside the remaining inner loops,
+     * rather than each running the inner loops in turn. This is
+     * register blocking: e.g. for a matrix multiply, unrolling and
+     * jamming the rows of the output by four computes four
+     * independent accumulators per iteration of the reduction
+     * loop. Pure dimensions may be jammed inside reduction
+     * dimensions, but a reduction dimension can't be moved inside
+     * another one. After this call, var refers to the outer dimension
+     * of the split. In update stages, TailStrategy::Auto guards the
+     * tail of a pure dimension with an if, rather than rounding up. */
+    EXPORT Func &unroll_and_jam(VarOrRVar var, int factor, TailStrategy tail = TailStrategy::Auto);
+
     /** Statically declare that the range over which a function should
      * be evaluated is given by the second and third arguments. This
      * can let Halide perform some optimizations. E.g. if you know
@@ -1772,6 +1822,36 @@ public:
      */
     EXPORT Func &memoize();
 
+    /** Write this function with non-temporal (streaming) stores,
+     * which bypass the cache. This is useful for large outputs that
+     * are written once and not read again by the pipeline, because
+     * they then don't evict values that later stages still need. Only
+     * dense vector stores are affected, and only ones the backend can
+     * prove are aligned to the vector size are actually streamed, so
+     * you'll usually want to vectorize the innermost dimension,
+     * constrain its min to a multiple of the vector size, and set the
+     * host alignment of the output buffer. On x86 this uses movnt*
+     * instructions followed by an sfence once the function has been
+     * computed, and on ARM it uses stnp where available. On other
+     * targets it has no effect. */
+    EXPORT Func &store_nontemporal();
+
+    /** Set the type of memory this Func should be stored in. By
+     * default (MemoryType::Auto) small constant-sized allocations go
+     * on the stack and everything else goes on the heap. Stack and
+     * Register placement require the size to be bounded by a
+     * constant no larger than the stack allocation limit, which
+     * defaults to 1MB and can be changed with the environment
+     * variable HL_MAX_STACK_ALLOCATION. PerTask storage is allocated
+     * on the heap outside the serial loops that enclose the Func, and
+     * reused by every iteration of them. It is allocated once per
+     * task, i.e. once per iteration of the innermost enclosing
+     * parallel loop, so parallelize over coarse tiles to benefit. This
+     * avoids a halide_malloc per tile for small scratch buffers whose
+     * size isn't a compile-time constant. Has no effect on Funcs
+     * computed inside GPU kernels. */
+    EXPORT Func &store_in(MemoryType memory_type);
+
 
     /** Allocate storage for this function within f's loop over
      * var. Scheduling storage is optional, and can be used to
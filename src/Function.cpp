@@ -439,7 +439,7 @@ void Function::define(const vector<string> &args, vector<Expr> values) {
     }
 
     for (size_t i = 0; i < args.size(); i++) {
-        Dim d = {args[i], ForType::Serial, DeviceAPI::None, Dim::Type::PureVar};
+        Dim d = {args[i], ForType::Serial, DeviceAPI::None, Dim::Type::PureVar, false};
         contents->init_def.schedule().dims().push_back(d);
         StorageDim sd = {args[i]};
         contents->init_def.schedule().storage_dims().push_back(sd);
@@ -447,7 +447,7 @@ void Function::define(const vector<string> &args, vector<Expr> values) {
 
     // Add the dummy outermost dim
     {
-        Dim d = {Var::outermost().name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar};
+        Dim d = {Var::outermost().name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar, false};
         contents->init_def.schedule().dims().push_back(d);
     }
 
@@ -636,7 +636,7 @@ void Function::define_update(const vector<Expr> &_args, vector<Expr> values) {
             bool pure = can_parallelize_rvar(v, name(), r);
 
             Dim d = {v, ForType::Serial, DeviceAPI::None,
-                     pure ? Dim::Type::PureRVar : Dim::Type::ImpureRVar};
+                     pure ? Dim::Type::PureRVar : Dim::Type::ImpureRVar, false};
             r.schedule().dims().push_back(d);
         }
     }
@@ -644,14 +644,14 @@ void Function::define_update(const vector<Expr> &_args, vector<Expr> values) {
     // Then add the pure args outside of that
     for (size_t i = 0; i < pure_args.size(); i++) {
         if (!pure_args[i].empty()) {
-            Dim d = {pure_args[i], ForType::Serial, DeviceAPI::None, Dim::Type::PureVar};
+            Dim d = {pure_args[i], ForType::Serial, DeviceAPI::None, Dim::Type::PureVar, false};
             r.schedule().dims().push_back(d);
         }
     }
 
     // Then the dummy outermost dim
     {
-        Dim d = {Var::outermost().name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar};
+        Dim d = {Var::outermost().name(), ForType::Serial, DeviceAPI::None, Dim::Type::PureVar, false};
         r.schedule().dims().push_back(d);
     }
 
@@ -10,6 +10,7 @@
 #include "Substitute.h"
 #include "Scope.h"
 #include "Bounds.h"
+#include "FixedPoint.h"
 #include "Lerp.h"
 
 namespace Halide {
@@ -871,6 +872,10 @@ private:
             // that they generate.
             internal_assert(op->args.size() == 3);
             expr = mutate(lower_lerp(op->args[0], op->args[1], op->args[2]));
+        } else if (is_fixed_point_intrinsic(op)) {
+            // Likewise for the fixed-point intrinsics, which lower to
+            // the patterns above.
+            expr = mutate(lower_fixed_point_intrinsic(op));
         } else if (op->is_intrinsic(Call::cast_mask)) {
             internal_assert(op->args.size() == 1);
             Type src_type = op->args[0].type();
@@ -1354,7 +1359,7 @@ class EliminateInterleaves : public IRMutator {
 
         if (!body.same_as(op->body) || !condition.same_as(op->condition)) {
             stmt = Allocate::make(op->name, op->type, op->extents, condition, body,
-                                  op->new_expr, op->free_function);
+                                  op->new_expr, op->free_function, op->memory_type);
         } else {
             stmt = op;
         }
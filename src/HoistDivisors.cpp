@@ -0,0 +1,287 @@
+#include "HoistDivisors.h"
+#include "ExprUsesVar.h"
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Scope.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// Division by a loop-invariant d is done with the method in
+// "Division by Invariant Integers using Multiplication", Granlund and
+// Montgomery, 1994 (figure 4.1). For N-bit unsigned n and d != 0:
+//
+// l = ceil(log2(d))
+// m = floor(2^N * (2^l - d) / d) + 1
+// t = mulhi(m, n)
+// n / d = (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0)
+//
+// m fits in N bits, and computing it takes a 2N-bit division, which
+// is why we do it outside the loop. Signed division divides the
+// magnitudes, with the usual trick of flipping the bits of negative
+// numerators to get rounding towards negative infinity, and then
+// negates the result for negative divisors.
+struct HoistedDivisor {
+    // The scalar type of the division, and the divisor
+    Type type;
+    Expr divisor;
+
+    // The names of the lets that hold the multiplier, the two
+    // shifts, and (for signed types) an all-ones mask if the divisor
+    // is negative. All are unsigned.
+    string mul, sh1, sh2, sign;
+};
+
+// Check that an expression can be evaluated anywhere, and gets the
+// same result anywhere, as long as its free variables mean the same
+// thing.
+class IsPure : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        result = false;
+    }
+
+    void visit(const Call *op) {
+        if (op->call_type != Call::PureIntrinsic &&
+            op->call_type != Call::PureExtern) {
+            result = false;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+public:
+    bool result = true;
+};
+
+bool is_pure(Expr e) {
+    IsPure pure;
+    e.accept(&pure);
+    return pure.result;
+}
+
+class HoistDivisors : public IRMutator {
+    using IRMutator::visit;
+
+    // The divisors hoisted out of the innermost enclosing loop, and
+    // the variables defined inside that loop.
+    vector<HoistedDivisor> *hoisted = nullptr;
+    Scope<int> *loop_vars = nullptr;
+
+    void visit(const For *op) {
+        // Leave device code alone.
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            stmt = op;
+            return;
+        }
+
+        vector<HoistedDivisor> loop_hoisted;
+        Scope<int> loop_loop_vars;
+        loop_loop_vars.push(op->name, 0);
+
+        vector<HoistedDivisor> *old_hoisted = hoisted;
+        Scope<int> *old_loop_vars = loop_vars;
+        hoisted = &loop_hoisted;
+        loop_vars = &loop_loop_vars;
+        Stmt body = mutate(op->body);
+        hoisted = old_hoisted;
+        loop_vars = old_loop_vars;
+
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, op->min, op->extent,
+                             op->for_type, op->device_api, body);
+        }
+
+        for (size_t i = loop_hoisted.size(); i > 0; i--) {
+            stmt = make_lets(loop_hoisted[i - 1], stmt);
+        }
+    }
+
+    void visit(const LetStmt *op) {
+        if (loop_vars) {
+            loop_vars->push(op->name, 0);
+        }
+        IRMutator::visit(op);
+        if (loop_vars) {
+            loop_vars->pop(op->name);
+        }
+    }
+
+    void visit(const Let *op) {
+        if (loop_vars) {
+            loop_vars->push(op->name, 0);
+        }
+        IRMutator::visit(op);
+        if (loop_vars) {
+            loop_vars->pop(op->name);
+        }
+    }
+
+    // If the divisor of a vector division or modulo is
+    // loop-invariant, return it as a scalar.
+    Expr invariant_divisor(Type t, Expr b) {
+        if (!hoisted ||
+            !t.is_vector() ||
+            !(t.is_int() || t.is_uint()) ||
+            (t.bits() != 8 && t.bits() != 16 && t.bits() != 32)) {
+            return Expr();
+        }
+        const Broadcast *broadcast = b.as<Broadcast>();
+        if (!broadcast ||
+            is_const(broadcast->value) ||
+            expr_uses_vars(broadcast->value, *loop_vars) ||
+            !is_pure(broadcast->value)) {
+            return Expr();
+        }
+        return broadcast->value;
+    }
+
+    HoistedDivisor hoist(Type t, Expr d) {
+        for (const HoistedDivisor &h : *hoisted) {
+            if (h.type == t && equal(h.divisor, d)) {
+                return h;
+            }
+        }
+        HoistedDivisor h;
+        h.type = t;
+        h.divisor = d;
+        string name = unique_name("divisor");
+        h.mul = name + ".mul";
+        h.sh1 = name + ".sh1";
+        h.sh2 = name + ".sh2";
+        h.sign = name + ".sign";
+        hoisted->push_back(h);
+        return h;
+    }
+
+    // Wrap a loop in the lets that compute the multiplier and shifts
+    // for a divisor.
+    Stmt make_lets(const HoistedDivisor &h, Stmt s) {
+        const int bits = h.type.bits();
+        Type u = UInt(bits);
+        Type w = UInt(bits * 2);
+
+        string d_name = h.mul + ".divisor";
+        Expr d = Variable::make(u, d_name);
+        Expr dw = cast(w, d);
+
+        // l = ceil(log2(d)), computed without taking the count of
+        // leading zeros of zero when d == 1.
+        string l_name = h.mul + ".log2";
+        Expr l = Variable::make(u, l_name);
+        Expr l_val = cast(u, make_const(w, bits * 2 - 1) - count_leading_zeros(dw * 2 - 1));
+
+        Expr mul = cast(u, ((((make_one(w) << cast(w, l)) - dw) << bits) / dw) + 1);
+        Expr sh1 = min(l, 1);
+        Expr sh2 = max(l, 1) - 1;
+
+        s = LetStmt::make(h.sh2, sh2, s);
+        s = LetStmt::make(h.sh1, sh1, s);
+        s = LetStmt::make(h.mul, mul, s);
+        s = LetStmt::make(l_name, l_val, s);
+
+        // Division by zero is undefined, but the loop might never
+        // have run, so make sure we don't fault out here. Signed
+        // divisors are replaced by their magnitude.
+        if (h.type.is_int()) {
+            Expr sign = Variable::make(u, h.sign);
+            s = LetStmt::make(d_name, max((cast(u, h.divisor) ^ sign) - sign, 1), s);
+            s = LetStmt::make(h.sign, cast(u, h.divisor >> (bits - 1)), s);
+        } else {
+            s = LetStmt::make(d_name, max(h.divisor, 1), s);
+        }
+        return s;
+    }
+
+    // Divide a vector by a hoisted divisor.
+    Expr divide(Expr n, const HoistedDivisor &h) {
+        Type t = n.type();
+        const int bits = t.bits();
+        const int lanes = t.lanes();
+        Type u = t.with_code(Type::UInt);
+        Type w = u.with_bits(bits * 2);
+
+        Expr mul = Broadcast::make(Variable::make(u.element_of(), h.mul), lanes);
+        Expr sh1 = Broadcast::make(Variable::make(u.element_of(), h.sh1), lanes);
+        Expr sh2 = Broadcast::make(Variable::make(u.element_of(), h.sh2), lanes);
+
+        string n_name = unique_name('n');
+        Expr n_var = Variable::make(t, n_name);
+
+        // Flip the bits of negative numerators.
+        Expr num = cast(u, n_var);
+        Expr num_sign;
+        if (t.is_int()) {
+            num_sign = cast(u, n_var >> (bits - 1));
+            num = num ^ num_sign;
+        }
+
+        // Multiply-keep-high-half
+        Expr q = cast(w, num) * cast(w, mul);
+        if (bits < 32) {
+            q = q / (1 << bits);
+        } else {
+            q = q >> bits;
+        }
+        q = cast(u, q);
+
+        q = (q + ((num - q) >> sh1)) >> sh2;
+
+        if (t.is_int()) {
+            // Flip the bits back, and negate if the divisor is negative.
+            Expr sign = Broadcast::make(Variable::make(u.element_of(), h.sign), lanes);
+            q = q ^ num_sign;
+            q = (q ^ sign) - sign;
+        }
+
+        return Let::make(n_name, n, cast(t, q));
+    }
+
+    void visit(const Div *op) {
+        Expr d = invariant_divisor(op->type, op->b);
+        if (!d.defined()) {
+            IRMutator::visit(op);
+            return;
+        }
+        Expr a = mutate(op->a);
+        expr = divide(a, hoist(op->type.element_of(), d));
+    }
+
+    void visit(const Mod *op) {
+        Expr d = invariant_divisor(op->type, op->b);
+        if (!d.defined()) {
+            IRMutator::visit(op);
+            return;
+        }
+        Expr a = mutate(op->a);
+        HoistedDivisor h = hoist(op->type.element_of(), d);
+        // a % b = a - (a / b) * b, which is in [0, |b|) because
+        // Halide's division is Euclidean. The intermediate product
+        // can overflow for signed types, so do it unsigned.
+        Type u = op->type.with_code(Type::UInt);
+        string n_name = unique_name('n');
+        Expr n_var = Variable::make(op->type, n_name);
+        Expr r = cast(u, n_var) - cast(u, divide(n_var, h)) * cast(u, op->b);
+        expr = Let::make(n_name, a, cast(op->type, r));
+    }
+};
+
+}  // namespace
+
+Stmt hoist_loop_invariant_divisors(Stmt s) {
+    return HoistDivisors().mutate(s);
+}
+
+}
+}
@@ -0,0 +1,27 @@
+#ifndef HALIDE_HOIST_DIVISORS_H
+#define HALIDE_HOIST_DIVISORS_H
+
+/** \file
+ * Defines the lowering pass that replaces vector integer division by
+ * a loop-invariant value with multiplies and shifts.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find vector integer divisions and modulos by values that aren't
+ * compile-time constants, but that don't change inside the innermost
+ * enclosing loop (e.g. a Param). Compute a multiplier and shifts for
+ * each such divisor once, outside that loop, and replace the
+ * divisions with a multiply-keep-high-half and shifts, which
+ * vectorize well. Without this, vector integer division is done one
+ * lane at a time. Handles 8, 16, and 32-bit types. Device loops are
+ * left alone. */
+Stmt hoist_loop_invariant_divisors(Stmt s);
+
+}
+}
+
+#endif
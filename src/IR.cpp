@@ -377,7 +377,8 @@ Stmt Provide::make(const std::string &name, const std::vector<Expr> &values, con
 
 Stmt Allocate::make(const std::string &name, Type type, const std::vector<Expr> &extents,
                     const Expr &condition, const Stmt &body,
-                    const Expr &new_expr, const std::string &free_function) {
+                    const Expr &new_expr, const std::string &free_function,
+                    MemoryType memory_type) {
     for (size_t i = 0; i < extents.size(); i++) {
         internal_assert(extents[i].defined()) << "Allocate of undefined extent\n";
         internal_assert(extents[i].type().is_scalar() == 1) << "Allocate of vector extent\n";
@@ -389,6 +390,7 @@ Stmt Allocate::make(const std::string &name, Type type, const std::vector<Expr>
     Allocate *node = new Allocate;
     node->name = name;
     node->type = type;
+    node->memory_type = memory_type;
     node->extents = extents;
     node->new_expr = new_expr;
     node->free_function = free_function;
@@ -813,6 +815,15 @@ Call::ConstString Call::bool_to_mask = "bool_to_mask";
 Call::ConstString Call::cast_mask = "cast_mask";
 Call::ConstString Call::select_mask = "select_mask";
 Call::ConstString Call::extract_mask_element = "extract_mask_element";
+Call::ConstString Call::nontemporal_stores = "nontemporal_stores";
+Call::ConstString Call::widening_add = "widening_add";
+Call::ConstString Call::widening_mul = "widening_mul";
+Call::ConstString Call::saturating_add = "saturating_add";
+Call::ConstString Call::saturating_sub = "saturating_sub";
+Call::ConstString Call::halving_add = "halving_add";
+Call::ConstString Call::rounding_halving_add = "rounding_halving_add";
+Call::ConstString Call::rounding_shift_right = "rounding_shift_right";
+Call::ConstString Call::rounding_mul_shift_right = "rounding_mul_shift_right";
 
 Call::ConstString Call::buffer_get_min = "_halide_buffer_get_min";
 Call::ConstString Call::buffer_get_max = "_halide_buffer_get_max";
@@ -335,6 +335,7 @@ struct Provide : public StmtNode<Provide> {
 struct Allocate : public StmtNode<Allocate> {
     std::string name;
     Type type;
+    MemoryType memory_type;
     std::vector<Expr> extents;
     Expr condition;
 
@@ -351,7 +352,8 @@ struct Allocate : public StmtNode<Allocate> {
 
     EXPORT static Stmt make(const std::string &name, Type type, const std::vector<Expr> &extents,
                             const Expr &condition, const Stmt &body,
-                            const Expr &new_expr = Expr(), const std::string &free_function = std::string());
+                            const Expr &new_expr = Expr(), const std::string &free_function = std::string(),
+                            MemoryType memory_type = MemoryType::Auto);
 
     /** A routine to check if the extents are all constants, and if so verify
      * the total size is less than 2^31 - 1. If the result is constant, but
@@ -502,7 +504,16 @@ struct Call : public ExprNode<Call> {
         bool_to_mask,
         cast_mask,
         select_mask,
-        extract_mask_element;
+        extract_mask_element,
+        nontemporal_stores,
+        widening_add,
+        widening_mul,
+        saturating_add,
+        saturating_sub,
+        halving_add,
+        rounding_halving_add,
+        rounding_shift_right,
+        rounding_mul_shift_right;
 
     // We also declare some symbolic names for some of the runtime
     // functions that we want to construct Call nodes to here to avoid
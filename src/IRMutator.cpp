@@ -271,7 +271,7 @@ void IRMutator::visit(const Allocate *op) {
         new_expr.same_as(op->new_expr)) {
         stmt = op;
     } else {
-        stmt = Allocate::make(op->name, op->type, new_extents, condition, body, new_expr, op->free_function);
+        stmt = Allocate::make(op->name, op->type, new_extents, condition, body, new_expr, op->free_function, op->memory_type);
     }
 }
 
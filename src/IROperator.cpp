@@ -405,7 +405,11 @@ void match_types(Expr &a, Expr &b) {
         b = cast(ta, b);
     } else if (ta.is_float() && tb.is_float()) {
         // float(a) * float(b) -> float(max(a, b))
-        if (ta.bits() > tb.bits()) b = cast(ta, b);
+        // float16(a) * bfloat16(b) -> float32(a) * float32(b)
+        if (ta.bits() == tb.bits() && ta.code() != tb.code()) {
+            a = cast(Float(32, ta.lanes()), a);
+            b = cast(Float(32, tb.lanes()), b);
+        } else if (ta.bits() > tb.bits()) b = cast(ta, b);
         else a = cast(tb, a);
     } else if (ta.is_uint() && tb.is_uint()) {
         // uint(a) * uint(b) -> uint(max(a, b))
@@ -585,6 +589,258 @@ Expr halide_erf(const Expr &x_full) {
     return result;
 }
 
+namespace {
+
+// Trig functions based on those from Cephes
+// (http://www.netlib.org/cephes/). Set fast to use shorter
+// polynomials, tuned to minimize the maximum relative error.
+
+const double pi = 3.14159265358979323846;
+
+// The range reduction below is exact enough for the polynomials to
+// keep their accuracy for arguments of magnitude less than this.
+const float trig_max_arg = 32768.0f;
+
+// Reduce the magnitude of x to within pi/4 of a multiple of pi/2,
+// and return which multiple of pi/4 we rounded to, which is always
+// even. Arguments outside the range that can be reduced accurately,
+// including infinities and NaNs, are flagged as exceptional and
+// reduced as if they were zero.
+void range_reduce_trig(const Expr &x_abs, Expr *reduced, Expr *octant, Expr *exceptional) {
+    Type type = x_abs.type();
+    Type int_type = Int(32, type.lanes());
+
+    *exceptional = halide_trig_out_of_range(x_abs);
+    Expr x = select(*exceptional, make_zero(type), x_abs);
+
+    Expr j = cast(int_type, x * (float)(4 / pi));
+    j = (j + 1) & make_const(int_type, ~1);
+    Expr y = cast(type, j);
+
+    // Subtract y * pi/4 in four parts. The first has few enough bits
+    // that its product with y is exact, and the last two keep the
+    // result accurate near the zeros of sin, cos and tan.
+    *reduced = (((x - y * 0.78515625f)
+                 - y * 2.4175643920898438e-4f)
+                - y * 1.5692785382270813e-7f)
+               - y * 3.0385503141383552e-11f;
+    *octant = j;
+}
+
+// The sign bit of a float, which unlike x < 0.0f is set for -0.0f.
+Expr sign_bit(const Expr &x) {
+    return reinterpret(Int(32, x.type().lanes()), x) < 0;
+}
+
+// The sine and cosine of a value in [-pi/4, pi/4]
+Expr sin_poly(const Expr &x, bool fast) {
+    Expr z = x * x;
+    Expr p;
+    if (fast) {
+        float coeff[] = {0.008163282048366643f,
+                         -0.16663390383674204f};
+        p = evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    } else {
+        float coeff[] = {-1.9515295891e-4f,
+                         8.3321608736e-3f,
+                         -1.6666654611e-1f};
+        p = evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    }
+    return p * z * x + x;
+}
+
+Expr cos_poly(const Expr &x, bool fast) {
+    Expr z = x * x;
+    if (fast) {
+        float coeff[] = {-0.0013648713563200734f,
+                         0.04166107126110754f,
+                         -0.5f,
+                         1.0f};
+        return evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    } else {
+        float coeff[] = {2.443315711809948e-5f,
+                         -1.388731625493765e-3f,
+                         4.166664568298827e-2f,
+                         -0.5f,
+                         1.0f};
+        return evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    }
+}
+
+Expr sin_or_cos(const Expr &x_full, bool is_cos, bool fast) {
+    Type type = x_full.type();
+    Type int_type = Int(32, type.lanes());
+    internal_assert(type.element_of() == Float(32));
+
+    Expr reduced, octant, exceptional;
+    range_reduce_trig(abs(x_full), &reduced, &octant, &exceptional);
+
+    Expr s = sin_poly(reduced, fast);
+    Expr c = cos_poly(reduced, fast);
+
+    // Octants 2 and 6 swap sine and cosine, and octants 4 and 6
+    // (or 2 and 4, for cosine) negate the result.
+    Expr swap = (octant & make_const(int_type, 2)) != 0;
+    Expr result;
+    if (is_cos) {
+        result = select(swap, s, c);
+        result = select(((octant + 2) & make_const(int_type, 4)) != 0, -result, result);
+    } else {
+        result = select(swap, c, s);
+        result = select((octant & make_const(int_type, 4)) != 0, -result, result);
+        // sin is odd
+        result = select(sign_bit(x_full), -result, result);
+    }
+
+    Expr nan = Call::make(type, "nan_f32", {}, Call::PureExtern);
+    result = select(exceptional, nan, result);
+
+    return common_subexpression_elimination(result);
+}
+
+Expr atan_impl(const Expr &x_full, bool fast) {
+    Type type = x_full.type();
+    internal_assert(type.element_of() == Float(32));
+
+    // Reduce the argument to within tan(pi/8) of zero, using the
+    // identities atan(x) = pi/2 - atan(1/x), and
+    // atan(x) = pi/4 + atan((x - 1)/(x + 1)). Infinities reduce to
+    // -1/inf, which gives pi/2. NaNs fail both comparisons and pass
+    // straight through.
+    Expr x_abs = abs(x_full);
+    Expr big = x_abs > 2.414213562373095f;
+    Expr mid = x_abs > 0.4142135623730950f;
+    Expr x = select(big, -1.0f / x_abs,
+                    mid, (x_abs - 1.0f) / (x_abs + 1.0f),
+                    x_abs);
+    Expr offset = select(big, make_const(type, pi / 2),
+                         mid, make_const(type, pi / 4),
+                         make_zero(type));
+
+    Expr z = x * x;
+    Expr p;
+    if (fast) {
+        float coeff[] = {-0.11225163613607424f,
+                         0.19714143918328472f,
+                         -0.33325507796155396f};
+        p = evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    } else {
+        float coeff[] = {8.05374449538e-2f,
+                         -1.38776856032e-1f,
+                         1.99777106478e-1f,
+                         -3.33329491539e-1f};
+        p = evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0]));
+    }
+    Expr result = offset + (p * z * x + x);
+    result = select(sign_bit(x_full), -result, result);
+
+    return common_subexpression_elimination(result);
+}
+
+Expr atan2_impl(const Expr &y, const Expr &x, bool fast) {
+    Type type = x.type();
+    internal_assert(type.element_of() == Float(32) && y.type() == type);
+
+    Expr result = atan_impl(y / x, fast);
+
+    // Move the result into the right quadrant. Like the system
+    // atan2, we go by the sign bits rather than comparing against
+    // zero, so that e.g. atan2(-0.0f, -1.0f) is -pi and
+    // atan2(0.0f, -0.0f) is pi.
+    Expr x_neg = sign_bit(x);
+    Expr y_neg = sign_bit(y);
+    result = select(x_neg, select(y_neg, result - (float)pi, result + (float)pi), result);
+    result = select(x == 0.0f, select(y > 0.0f, make_const(type, pi / 2),
+                                      y < 0.0f, make_const(type, -pi / 2),
+                                      x_neg && y == 0.0f, select(y_neg, make_const(type, -pi), make_const(type, pi)),
+                                      y), result);
+
+    // y / x is NaN when both are infinite, but the angle is still a
+    // diagonal. Only infinities are larger than the largest float.
+    Expr both_inf = abs(x) > type.max() && abs(y) > type.max();
+    Expr diagonal = select(x_neg, make_const(type, 3 * pi / 4), make_const(type, pi / 4));
+    result = select(both_inf, select(y_neg, -diagonal, diagonal), result);
+
+    return common_subexpression_elimination(result);
+}
+
+// The maximum errors in ulp of the accurate and the fast polynomials
+// above, measured against double-precision libm. For sin and cos
+// this is over all arguments of magnitude less than trig_max_arg.
+const int sin_cos_ulps[] = {3, 27};
+const int atan_ulps[] = {3, 12};
+const int atan2_ulps[] = {4, 13};
+
+// Check that one of the polynomial approximations is accurate enough
+// for a fast_ trig function, and return whether the cheaper one is.
+bool use_fast_polynomial(const char *name, int max_ulp_error, const int ulps[2]) {
+    user_assert(max_ulp_error >= ulps[0])
+        << name << " can't be computed to within " << max_ulp_error
+        << " ulp. Its most accurate approximation has an error of up to "
+        << ulps[0] << " ulp.\n";
+    return max_ulp_error >= ulps[1];
+}
+
+}
+
+Expr halide_trig_out_of_range(const Expr &x) {
+    return abs(x) >= trig_max_arg || is_nan(x);
+}
+
+Expr halide_sin(const Expr &x) {
+    return sin_or_cos(x, false, false);
+}
+
+Expr halide_cos(const Expr &x) {
+    return sin_or_cos(x, true, false);
+}
+
+Expr halide_tan(const Expr &x_full) {
+    Type type = x_full.type();
+    Type int_type = Int(32, type.lanes());
+    internal_assert(type.element_of() == Float(32));
+
+    Expr x, octant, exceptional;
+    range_reduce_trig(abs(x_full), &x, &octant, &exceptional);
+
+    Expr z = x * x;
+    float coeff[] = {9.38540185543e-3f,
+                     3.11992232697e-3f,
+                     2.44301354525e-2f,
+                     5.34112807005e-2f,
+                     1.33387994085e-1f,
+                     3.33331568548e-1f};
+    Expr result = evaluate_polynomial(z, coeff, sizeof(coeff)/sizeof(coeff[0])) * z * x + x;
+
+    // In octants 2 and 6, tan(x) = -1/tan(x - pi/2)
+    result = select((octant & make_const(int_type, 2)) != 0, -1.0f / result, result);
+    result = select(sign_bit(x_full), -result, result);
+
+    Expr nan = Call::make(type, "nan_f32", {}, Call::PureExtern);
+    result = select(exceptional, nan, result);
+
+    return common_subexpression_elimination(result);
+}
+
+Expr halide_atan(const Expr &x) {
+    return atan_impl(x, false);
+}
+
+Expr halide_atan2(const Expr &y, const Expr &x) {
+    return atan2_impl(y, x, false);
+}
+
+Expr halide_asin(const Expr &x) {
+    // Computing the cosine as sqrt((1 - x)(1 + x)) rather than
+    // sqrt(1 - x^2) is more accurate near +/-1. Outside of [-1, 1]
+    // the sqrt is NaN, and so is the result.
+    return atan2_impl(x, sqrt((1.0f - x) * (1.0f + x)), false);
+}
+
+Expr halide_acos(const Expr &x) {
+    return atan2_impl(sqrt((1.0f - x) * (1.0f + x)), x, false);
+}
+
 Expr raise_to_integer_power(const Expr &e, int64_t p) {
     Expr result;
     if (p == 0) {
@@ -696,6 +952,31 @@ Expr fast_log(const Expr &x) {
     return result;
 }
 
+Expr fast_sin(const Expr &x, int max_ulp_error) {
+    user_assert(x.type() == Float(32)) << "fast_sin only works for Float(32)";
+    bool fast = Internal::use_fast_polynomial("fast_sin", max_ulp_error, Internal::sin_cos_ulps);
+    return Internal::sin_or_cos(x, false, fast);
+}
+
+Expr fast_cos(const Expr &x, int max_ulp_error) {
+    user_assert(x.type() == Float(32)) << "fast_cos only works for Float(32)";
+    bool fast = Internal::use_fast_polynomial("fast_cos", max_ulp_error, Internal::sin_cos_ulps);
+    return Internal::sin_or_cos(x, true, fast);
+}
+
+Expr fast_atan(const Expr &x, int max_ulp_error) {
+    user_assert(x.type() == Float(32)) << "fast_atan only works for Float(32)";
+    bool fast = Internal::use_fast_polynomial("fast_atan", max_ulp_error, Internal::atan_ulps);
+    return Internal::atan_impl(x, fast);
+}
+
+Expr fast_atan2(const Expr &y, const Expr &x, int max_ulp_error) {
+    user_assert(y.type() == Float(32) && x.type() == Float(32))
+        << "fast_atan2 only works for Float(32)";
+    bool fast = Internal::use_fast_polynomial("fast_atan2", max_ulp_error, Internal::atan2_ulps);
+    return Internal::atan2_impl(y, x, fast);
+}
+
 Expr fast_exp(const Expr &x_full) {
     user_assert(x_full.type() == Float(32)) << "fast_exp only works for Float(32)";
 
@@ -836,4 +1117,97 @@ Expr saturating_cast(Type t, Expr e) {
     return e;
 }
 
+namespace {
+
+// Check and match the types of the args of a fixed-point
+// intrinsic. Integer constants are cast to the type of the other arg,
+// as for lerp.
+void match_fixed_point_types(Expr &a, Expr &b, const char *name) {
+    user_assert(a.defined() && b.defined()) << name << " of undefined Expr\n";
+    if (as_const_int(a)) {
+        a = cast(b.type(), a);
+    }
+    if (as_const_int(b)) {
+        b = cast(a.type(), b);
+    }
+    user_assert(a.type() == b.type())
+        << "The args to " << name << " must have the same type, but "
+        << a << " has type " << a.type() << " and "
+        << b << " has type " << b.type() << "\n";
+    user_assert(a.type().is_int() || a.type().is_uint())
+        << "The args to " << name << " must be integers, but "
+        << a << " has type " << a.type() << "\n";
+    user_assert(a.type().bits() <= 32)
+        << name << " is only defined for types of up to 32 bits, but "
+        << a << " has type " << a.type() << "\n";
+}
+
+Expr fixed_point_intrinsic(const char *name, Expr a, Expr b, bool widen) {
+    match_fixed_point_types(a, b, name);
+    Type t = a.type();
+    if (widen) {
+        t = t.with_bits(t.bits() * 2);
+    }
+    return Internal::Call::make(t, name, {a, b}, Internal::Call::PureIntrinsic);
+}
+
+// Shift amounts are unsigned and of the same width as the value
+// being shifted, so that they vectorize along with it without any
+// further casts.
+Expr fixed_point_shift(const Expr &a, Expr shift, const char *name, int max_shift) {
+    user_assert(shift.defined()) << name << " of undefined Expr\n";
+    user_assert(shift.type().is_int() || shift.type().is_uint())
+        << "The shift in " << name << " must be an integer, but "
+        << shift << " has type " << shift.type() << "\n";
+    if (const int64_t *c = as_const_int(shift)) {
+        user_assert(*c >= 0 && *c < max_shift)
+            << "The shift in " << name << " must be in [0, "
+            << max_shift << "), but is " << *c << "\n";
+    }
+    return cast(a.type().with_code(Type::UInt), shift);
+}
+
+}
+
+Expr widening_add(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::widening_add, a, b, true);
+}
+
+Expr widening_mul(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::widening_mul, a, b, true);
+}
+
+Expr saturating_add(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::saturating_add, a, b, false);
+}
+
+Expr saturating_sub(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::saturating_sub, a, b, false);
+}
+
+Expr halving_add(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::halving_add, a, b, false);
+}
+
+Expr rounding_halving_add(Expr a, Expr b) {
+    return fixed_point_intrinsic(Internal::Call::rounding_halving_add, a, b, false);
+}
+
+Expr rounding_shift_right(Expr a, Expr b) {
+    user_assert(a.defined()) << "rounding_shift_right of undefined Expr\n";
+    user_assert((a.type().is_int() || a.type().is_uint()) && a.type().bits() <= 32)
+        << "rounding_shift_right is only defined for integers of up to 32 bits, but "
+        << a << " has type " << a.type() << "\n";
+    b = fixed_point_shift(a, b, "rounding_shift_right", a.type().bits());
+    return Internal::Call::make(a.type(), Internal::Call::rounding_shift_right,
+                                {a, b}, Internal::Call::PureIntrinsic);
+}
+
+Expr rounding_mul_shift_right(Expr a, Expr b, Expr q) {
+    match_fixed_point_types(a, b, "rounding_mul_shift_right");
+    q = fixed_point_shift(a, q, "rounding_mul_shift_right", a.type().bits() * 2);
+    return Internal::Call::make(a.type(), Internal::Call::rounding_mul_shift_right,
+                                {a, b, q}, Internal::Call::PureIntrinsic);
+}
+
 }
@@ -89,6 +89,7 @@ inline Expr make_const(Type t, uint8_t val)   {return make_const(t, (uint64_t)va
 inline Expr make_const(Type t, bool val)      {return make_const(t, (uint64_t)val);}
 inline Expr make_const(Type t, float val)     {return make_const(t, (double)val);}
 inline Expr make_const(Type t, float16_t val) {return make_const(t, (double)val);}
+inline Expr make_const(Type t, bfloat16_t val) {return make_const(t, (double)val);}
 // @}
 
 /** Check if a constant value can be correctly represented as the given type. */
@@ -157,8 +158,20 @@ EXPORT void match_types(Expr &a, Expr &b);
 EXPORT Expr halide_log(const Expr &a);
 EXPORT Expr halide_exp(const Expr &a);
 EXPORT Expr halide_erf(const Expr &a);
+EXPORT Expr halide_sin(const Expr &a);
+EXPORT Expr halide_cos(const Expr &a);
+EXPORT Expr halide_tan(const Expr &a);
+EXPORT Expr halide_asin(const Expr &a);
+EXPORT Expr halide_acos(const Expr &a);
+EXPORT Expr halide_atan(const Expr &a);
+EXPORT Expr halide_atan2(const Expr &y, const Expr &x);
 // @}
 
+/** Whether an argument is too large for halide_sin, halide_cos and
+ * halide_tan to reduce accurately, or is infinite or NaN. They
+ * return NaN for such arguments. */
+EXPORT Expr halide_trig_out_of_range(const Expr &a);
+
 /** Raise an expression to an integer power by repeatedly multiplying
  * it by itself. */
 EXPORT Expr raise_to_integer_power(const Expr &a, int64_t b);
@@ -826,6 +839,51 @@ inline Expr absd(Expr a, Expr b) {
                                 Internal::Call::PureIntrinsic);
 }
 
+/** Fixed-point arithmetic. These operators take two integers of the
+ * same type (integer constants are cast to match the other
+ * argument), and never overflow. They compile to single instructions
+ * where the target has them (e.g. paddusb, pavgb, and pmulhrsw on
+ * x86, or vqadd, vrhadd, and vqrdmulh on ARM), and to the equivalent
+ * wider arithmetic elsewhere. They are only defined for types of up
+ * to 32 bits. */
+// @{
+
+/** Add two integers, returning a result of twice the bit width, so
+ * the sum can't overflow. */
+EXPORT Expr widening_add(Expr a, Expr b);
+
+/** Multiply two integers, returning a result of twice the bit width,
+ * so the product can't overflow. */
+EXPORT Expr widening_mul(Expr a, Expr b);
+
+/** Add two integers, clamping the result to the range of the type
+ * instead of wrapping around. */
+EXPORT Expr saturating_add(Expr a, Expr b);
+
+/** Subtract two integers, clamping the result to the range of the
+ * type instead of wrapping around. */
+EXPORT Expr saturating_sub(Expr a, Expr b);
+
+/** Compute (a + b)/2, rounding down, without overflow in the
+ * intermediate sum. */
+EXPORT Expr halving_add(Expr a, Expr b);
+
+/** Compute (a + b + 1)/2, i.e. the average of a and b rounding up,
+ * without overflow in the intermediate sum. */
+EXPORT Expr rounding_halving_add(Expr a, Expr b);
+
+/** Shift a right by b bits, rounding to the nearest integer (ties
+ * round up) instead of down. The shift amount is treated as unsigned,
+ * and must be less than the bit width of a. */
+EXPORT Expr rounding_shift_right(Expr a, Expr b);
+
+/** Compute the product of a and b shifted right by q bits, rounding
+ * to nearest, and saturating to the range of the type. This is the
+ * usual fixed-point multiply: for 16-bit values in Q15 format, use
+ * q = 15. */
+EXPORT Expr rounding_mul_shift_right(Expr a, Expr b, Expr q);
+// @}
+
 /** Returns an expression similar to the ternary operator in C, except
  * that it always evaluates all arguments. If the first argument is
  * true, then return the second, else return the third. Typically
@@ -990,12 +1048,16 @@ inline Expr select(const Expr &c1, const Expr &v1,
 }
 // @}
 
-// TODO: Implement support for *_f16 external functions in various backends.
-// No backend supports these yet.
+// No backend has *_f16 versions of the math library, so calls to
+// them are done in Float(32) during lowering (see EmulateFloat16Math).
 
 /** Return the sine of a floating-point expression. If the argument is
- * not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * not floating-point, it is cast to Float(32). Scalars call the
+ * system sin function. Vectors of Float(32) use a polynomial
+ * approximation accurate to within 3 ulp, unless some lane has a
+ * magnitude of 32768 or more or is not finite, in which case every
+ * lane calls the system sin function. See fast_sin for a faster,
+ * less accurate approximation. */
 inline Expr sin(const Expr &x) {
     user_assert(x.defined()) << "sin of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1010,8 +1072,10 @@ inline Expr sin(const Expr &x) {
 }
 
 /** Return the arcsine of a floating-point expression. If the argument
- * is not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * is not floating-point, it is cast to Float(32). Scalars call the
+ * system asin function. Vectors of Float(32) use a polynomial
+ * approximation accurate to within 4 ulp, and vectorize
+ * cleanly. */
 inline Expr asin(const Expr &x) {
     user_assert(x.defined()) << "asin of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1026,8 +1090,12 @@ inline Expr asin(const Expr &x) {
 }
 
 /** Return the cosine of a floating-point expression. If the argument
- * is not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * is not floating-point, it is cast to Float(32). Scalars call the
+ * system cos function. Vectors of Float(32) use a polynomial
+ * approximation accurate to within 3 ulp, unless some lane has a
+ * magnitude of 32768 or more or is not finite, in which case every
+ * lane calls the system cos function. See fast_cos for a faster,
+ * less accurate approximation. */
 inline Expr cos(const Expr &x) {
     user_assert(x.defined()) << "cos of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1042,8 +1110,10 @@ inline Expr cos(const Expr &x) {
 }
 
 /** Return the arccosine of a floating-point expression. If the
- * argument is not floating-point, it is cast to Float(32). Does not
- * vectorize well. */
+ * argument is not floating-point, it is cast to Float(32). Scalars
+ * call the system acos function. Vectors of Float(32) use a
+ * polynomial approximation accurate to within 4 ulp, and
+ * vectorize cleanly. */
 inline Expr acos(const Expr &x) {
     user_assert(x.defined()) << "acos of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1058,8 +1128,11 @@ inline Expr acos(const Expr &x) {
 }
 
 /** Return the tangent of a floating-point expression. If the argument
- * is not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * is not floating-point, it is cast to Float(32). Scalars call the
+ * system tan function. Vectors of Float(32) use a polynomial
+ * approximation accurate to within 4 ulp, unless some lane has a
+ * magnitude of 32768 or more or is not finite, in which case every
+ * lane calls the system tan function. */
 inline Expr tan(const Expr &x) {
     user_assert(x.defined()) << "tan of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1074,8 +1147,11 @@ inline Expr tan(const Expr &x) {
 }
 
 /** Return the arctangent of a floating-point expression. If the
- * argument is not floating-point, it is cast to Float(32). Does not
- * vectorize well. */
+ * argument is not floating-point, it is cast to Float(32). Scalars
+ * call the system atan function. Vectors of Float(32) use a
+ * polynomial approximation accurate to within 3 ulp, and vectorize
+ * cleanly. See fast_atan for a faster, less accurate
+ * approximation. */
 inline Expr atan(const Expr &x) {
     user_assert(x.defined()) << "atan of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1090,8 +1166,11 @@ inline Expr atan(const Expr &x) {
 }
 
 /** Return the angle of a floating-point gradient. If the argument is
- * not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * not floating-point, it is cast to Float(32). Scalars call the
+ * system atan2 function. Vectors of Float(32) use a polynomial
+ * approximation accurate to within 4 ulp, and vectorize
+ * cleanly. See fast_atan2 for a faster, less accurate
+ * approximation. */
 inline Expr atan2(Expr y, Expr x) {
     user_assert(x.defined() && y.defined()) << "atan2 of undefined Expr\n";
 
@@ -1317,6 +1396,27 @@ EXPORT Expr fast_log(const Expr &x);
  * approaching overflow. Vectorizes cleanly. */
 EXPORT Expr fast_exp(const Expr &x);
 
+/** Fast approximate cleanly vectorizable sine and cosine for
+ * Float(32). The error is at most max_ulp_error units in the last
+ * place, and the cheapest approximation that meets that bound is
+ * used: the default of 27 ulp is the fastest, and the most accurate
+ * is 3 ulp. Returns NaN for arguments of magnitude 32768 or more,
+ * infinities and NaNs. Vectorizes cleanly. */
+// @{
+EXPORT Expr fast_sin(const Expr &x, int max_ulp_error = 27);
+EXPORT Expr fast_cos(const Expr &x, int max_ulp_error = 27);
+// @}
+
+/** Fast approximate cleanly vectorizable arctangent and angle of a
+ * gradient for Float(32). The error is at most max_ulp_error units
+ * in the last place, and the cheapest approximation that meets that
+ * bound is used: the defaults are the fastest, and the most accurate
+ * are 3 and 4 ulp respectively. Vectorizes cleanly. */
+// @{
+EXPORT Expr fast_atan(const Expr &x, int max_ulp_error = 12);
+EXPORT Expr fast_atan2(const Expr &y, const Expr &x, int max_ulp_error = 13);
+// @}
+
 /** Fast approximate cleanly vectorizable pow for Float(32). Returns
  * nonsense for x < 0.0f. Accurate up to the last 5 bits of the
  * mantissa for typical exponents. Gets worse when approaching
@@ -1428,7 +1528,7 @@ inline Expr is_nan(const Expr &x) {
     if (x.type().element_of() == Float(64)) {
         return Internal::Call::make(t, "is_nan_f64", {x}, Internal::Call::PureExtern);
     }
-    else if (x.type().element_of() == Float(64)) {
+    else if (x.type().element_of() == Float(16)) {
         return Internal::Call::make(t, "is_nan_f16", {x}, Internal::Call::PureExtern);
     }
     else {
@@ -26,6 +26,9 @@ ostream &operator<<(ostream &out, const Type &type) {
     case Type::Handle:
         out << "handle";
         break;
+    case Type::BFloat:
+        out << "bfloat";
+        break;
     }
     out << type.bits();
     if (type.lanes() > 1) out << 'x' << type.lanes();
@@ -87,6 +90,27 @@ ostream &operator<<(ostream &out, const DeviceAPI &api) {
     return out;
 }
 
+ostream &operator<<(ostream &out, const MemoryType &t) {
+    switch (t) {
+    case MemoryType::Auto:
+        out << "Auto";
+        break;
+    case MemoryType::Heap:
+        out << "Heap";
+        break;
+    case MemoryType::Stack:
+        out << "Stack";
+        break;
+    case MemoryType::Register:
+        out << "Register";
+        break;
+    case MemoryType::PerTask:
+        out << "PerTask";
+        break;
+    }
+    return out;
+}
+
 namespace Internal {
 
 void IRPrinter::test() {
@@ -238,6 +262,10 @@ void IRPrinter::visit(const UIntImm *op) {
 }
 
 void IRPrinter::visit(const FloatImm *op) {
+  if (op->type.is_bfloat()) {
+      stream << op->value << "bf";
+      return;
+  }
   switch (op->type.bits()) {
     case 64:
         stream << op->value;
@@ -559,6 +587,9 @@ void IRPrinter::visit(const Allocate *op) {
         print(op->extents[i]);
     }
     stream << "]";
+    if (op->memory_type != MemoryType::Auto) {
+        stream << " in " << op->memory_type;
+    }
     if (!is_one(op->condition)) {
         stream << " if ";
         print(op->condition);
@@ -538,7 +538,7 @@ class InjectBufferCopies : public IRMutator {
         // If this buffer is only ever touched on gpu, nuke the host-side allocation.
         if (!buf_info.host_touched) {
             debug(4) << "Eliding host alloc for " << op->name << "\n";
-            stmt = Allocate::make(op->name, op->type, op->extents, const_false(), op->body);
+            stmt = Allocate::make(op->name, op->type, op->extents, const_false(), op->body, Expr(), std::string(), op->memory_type);
         } else if (buf_info.on_single_device &&
                    buf_info.dev_touched) {
             debug(4) << "Making combined host/device alloc for " << op->name << "\n";
@@ -570,7 +570,7 @@ class InjectBufferCopies : public IRMutator {
                                         Call::make(Handle(), Call::buffer_get_host,
                                                    { Variable::make(type_of<struct buffer_t *>(), op->name + ".buffer") },
                                                    Call::Extern),
-                                        "halide_device_host_nop_free"); // TODO: really should not have to introduce this routine to get a nop free
+                                        "halide_device_host_nop_free", op->memory_type); // TODO: really should not have to introduce this routine to get a nop free
             // Wrap combined malloc around Allocate.
             inner_body = Block::make(combined_malloc, inner_body);
 
@@ -25,6 +25,10 @@ struct JITExtern;
 struct Target;
 class Module;
 
+namespace Runtime {
+class ScratchMemory;
+}
+
 namespace Internal {
 
 class JITModuleContents;
@@ -42,7 +46,8 @@ struct JITModule {
 
     EXPORT JITModule();
     EXPORT JITModule(const Module &m, const LoweredFunc &fn,
-                     const std::vector<JITModule> &dependencies = std::vector<JITModule>());
+                     const std::vector<JITModule> &dependencies = std::vector<JITModule>(),
+                     const std::vector<std::string> &requested_exports = std::vector<std::string>());
     /** The exports map of a JITModule contains all symbols which are
      * available to other JITModules which depend on this one. For
      * runtime modules, this is all of the symbols exported from the
@@ -141,6 +146,9 @@ struct JITHandlers {
 struct JITUserContext {
     void *user_context;
     JITHandlers handlers;
+    // Where the custom_malloc and custom_free handlers installed by
+    // Pipeline::set_scratch_memory get their memory from.
+    Runtime::ScratchMemory *scratch_memory{nullptr};
 };
 
 class JITSharedRuntime {
@@ -182,11 +182,13 @@ DECLARE_LL_INITMOD(ptx_compute_35)
 
 #ifdef WITH_X86
 DECLARE_LL_INITMOD(x86_avx)
+DECLARE_LL_INITMOD(x86_avx512)
 DECLARE_LL_INITMOD(x86)
 DECLARE_LL_INITMOD(x86_sse41)
 DECLARE_CPP_INITMOD(x86_cpu_features)
 #else
 DECLARE_NO_INITMOD(x86_avx)
+DECLARE_NO_INITMOD(x86_avx512)
 DECLARE_NO_INITMOD(x86)
 DECLARE_NO_INITMOD(x86_sse41)
 DECLARE_NO_INITMOD(x86_cpu_features)
@@ -778,6 +780,12 @@ std::unique_ptr<llvm::Module> get_initial_module_for_target(Target t, llvm::LLVM
             if (t.has_feature(Target::AVX)) {
                 modules.push_back(get_initmod_x86_avx_ll(c));
             }
+            #if LLVM_VERSION >= 40
+            if (t.has_feature(Target::AVX512_Skylake) ||
+                t.has_feature(Target::AVX512_Cannonlake)) {
+                modules.push_back(get_initmod_x86_avx512_ll(c));
+            }
+            #endif
             if (t.has_feature(Target::Profile)) {
                 modules.push_back(get_initmod_profiler_inlined(c, bits_64, debug));
             }
@@ -192,6 +192,16 @@ class LoopCarryOverLoop : public IRMutator {
     const Scope<int> &in_consume;
 
     int max_carried_values;
+    int register_bits;
+
+    // The number of registers needed to carry a value of the given type.
+    size_t registers_per_value(Type t) const {
+        if (register_bits <= 0) {
+            return 1;
+        }
+        int bits = t.bits() * t.lanes();
+        return (size_t)std::max(1, (bits + register_bits - 1) / register_bits);
+    }
 
     using IRMutator::visit;
 
@@ -353,15 +363,17 @@ class LoopCarryOverLoop : public IRMutator {
         vector<vector<int>> trimmed;
         size_t sz = 0;
         for (const vector<int> &c : chains) {
-            if (sz + c.size() > (size_t)max_carried_values) {
-                if (sz < (size_t)max_carried_values - 1) {
+            size_t regs = registers_per_value(loads[c[0]][0]->type);
+            if (sz + c.size() * regs > (size_t)max_carried_values) {
+                size_t partial = ((size_t)max_carried_values - sz) / regs;
+                if (partial > 1) {
                     // Take a partial chain
-                    trimmed.emplace_back(c.begin(), c.begin() + max_carried_values - sz);
+                    trimmed.emplace_back(c.begin(), c.begin() + partial);
                 }
                 break;
             }
             trimmed.push_back(c);
-            sz += c.size();
+            sz += c.size() * regs;
         }
         chains.swap(trimmed);
 
@@ -480,8 +492,8 @@ class LoopCarryOverLoop : public IRMutator {
     }
 
 public:
-    LoopCarryOverLoop(const string &var, const Scope<int> &s, int max_carried_values)
-        : in_consume(s), max_carried_values(max_carried_values) {
+    LoopCarryOverLoop(const string &var, const Scope<int> &s, int max_carried_values, int register_bits)
+        : in_consume(s), max_carried_values(max_carried_values), register_bits(register_bits) {
         linear.push(var, 1);
     }
 
@@ -499,6 +511,7 @@ class LoopCarry : public IRMutator {
     using IRMutator::visit;
 
     int max_carried_values;
+    int register_bits;
     Scope<int> in_consume;
 
     void visit(const ProducerConsumer *op) {
@@ -513,9 +526,13 @@ class LoopCarry : public IRMutator {
     }
 
     void visit(const For *op) {
-        if (op->for_type == ForType::Serial && !is_one(op->extent)) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // This loop gets compiled by some other backend.
+            stmt = op;
+        } else if (op->for_type == ForType::Serial && !is_one(op->extent)) {
             Stmt body = mutate(op->body);
-            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values);
+            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values, register_bits);
             body = carry.mutate(body);
             if (body.same_as(op->body)) {
                 stmt = op;
@@ -538,14 +555,15 @@ class LoopCarry : public IRMutator {
     }
 
 public:
-    LoopCarry(int max_carried_values) : max_carried_values(max_carried_values) {}
+    LoopCarry(int max_carried_values, int register_bits) :
+        max_carried_values(max_carried_values), register_bits(register_bits) {}
 };
 
 }
 
 
-Stmt loop_carry(Stmt s, int max_carried_values) {
-    s = LoopCarry(max_carried_values).mutate(s);
+Stmt loop_carry(Stmt s, int max_carried_values, int register_bits) {
+    s = LoopCarry(max_carried_values, register_bits).mutate(s);
     return s;
 }
 
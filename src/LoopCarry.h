@@ -10,9 +10,14 @@ namespace Internal {
  * induction variables instead of redoing the load. If the loads are
  * predicated, the predicates need to match. Can be an optimization or
  * pessimization depending on how good the L1 cache is on the architecture
- * and how many memory issue slots there are. Currently only intended
- * for Hexagon. */
-Stmt loop_carry(Stmt, int max_carried_values = 8);
+ * and how many memory issue slots there are. Always used for Hexagon,
+ * and for other targets with the loop_carry feature.
+ *
+ * At most max_carried_values registers are used per loop. If
+ * register_bits is non-zero, a carried value wider than that many
+ * bits counts as the number of registers needed to hold it. Loops
+ * that run on another device are left alone. */
+Stmt loop_carry(Stmt, int max_carried_values = 8, int register_bits = 0);
 
 }
 }
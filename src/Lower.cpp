@@ -8,6 +8,7 @@
 #include "AddImageChecks.h"
 #include "AddParameterChecks.h"
 #include "AllocationBoundsInference.h"
+#include "AllocationPlacement.h"
 #include "Bounds.h"
 #include "BoundsInference.h"
 #include "CSE.h"
@@ -17,12 +18,14 @@
 #include "DeepCopy.h"
 #include "Deinterleave.h"
 #include "EarlyFree.h"
+#include "EmulateFloat16Math.h"
 #include "FindCalls.h"
 #include "Func.h"
 #include "Function.h"
 #include "FuseGPUThreadLoops.h"
 #include "FuzzFloatStores.h"
 #include "HexagonOffload.h"
+#include "HoistDivisors.h"
 #include "InjectHostDevBufferCopies.h"
 #include "InjectImageIntrinsics.h"
 #include "InjectOpenGLIntrinsics.h"
@@ -32,6 +35,7 @@
 #include "IRPrinter.h"
 #include "LoopCarry.h"
 #include "Memoization.h"
+#include "NontemporalStores.h"
 #include "PartitionLoops.h"
 #include "Prefetch.h"
 #include "Profiling.h"
@@ -228,6 +232,10 @@ Stmt lower(const vector<Function> &output_funcs, const string &pipeline_name,
         debug(2) << "Lowering after injecting per-block gpu synchronization:\n" << s << "\n\n";
     }
 
+    debug(1) << "Placing allocations in the requested memory types...\n";
+    s = place_allocations(s);
+    debug(2) << "Lowering after placing allocations:\n" << s << "\n\n";
+
     debug(1) << "Simplifying...\n";
     s = simplify(s);
     s = unify_duplicate_lets(s);
@@ -244,10 +252,13 @@ Stmt lower(const vector<Function> &output_funcs, const string &pipeline_name,
     debug(2) << "Lowering after unrolling:\n" << s << "\n\n";
 
     debug(1) << "Vectorizing...\n";
-    s = vectorize_loops(s, t);
+    s = vectorize_loops(s, env, t);
     s = simplify(s);
     debug(2) << "Lowering after vectorizing:\n" << s << "\n\n";
 
+    debug(1) << "Checking register allocations...\n";
+    check_register_allocations(s);
+
     debug(1) << "Detecting vector interleavings...\n";
     s = rewrite_interleavings(s);
     s = simplify(s);
@@ -262,6 +273,24 @@ Stmt lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = trim_no_ops(s);
     debug(2) << "Lowering after loop trimming:\n" << s << "\n\n";
 
+    if (t.has_feature(Target::LoopCarry) && t.arch != Target::Hexagon) {
+        // Hexagon does this in its own backend.
+        debug(1) << "Carrying values across loop iterations...\n";
+        // Use at most half of the vector register file for carried
+        // values, so that the loop body itself doesn't spill.
+        int vector_registers = 16;
+        if (t.arch == Target::X86) {
+            vector_registers = t.bits == 32 ? 8 : (t.has_feature(Target::AVX512) ? 32 : 16);
+        } else if (t.arch == Target::ARM) {
+            vector_registers = t.bits == 32 ? 16 : 32;
+        }
+        int register_bits = std::max(t.natural_vector_size(UInt(8)) * 8,
+                                     t.natural_vector_size(Float(32)) * 32);
+        s = loop_carry(s, vector_registers / 2, register_bits);
+        s = simplify(s);
+        debug(2) << "Lowering after carrying values across loop iterations:\n" << s << "\n\n";
+    }
+
     debug(1) << "Injecting early frees...\n";
     s = inject_early_frees(s);
     debug(2) << "Lowering after injecting early frees:\n" << s << "\n\n";
@@ -278,6 +307,10 @@ Stmt lower(const vector<Function> &output_funcs, const string &pipeline_name,
         debug(2) << "Lowering after fuzzing floating point stores:\n" << s << "\n\n";
     }
 
+    debug(1) << "Emulating 16-bit floating point math...\n";
+    s = emulate_float16_math(s, t);
+    debug(2) << "Lowering after emulating 16-bit floating point math:\n" << s << "\n\n";
+
     debug(1) << "Simplifying...\n";
     s = common_subexpression_elimination(s);
 
@@ -296,6 +329,14 @@ Stmt lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = simplify(s);
     debug(1) << "Lowering after final simplification:\n" << s << "\n\n";
 
+    debug(1) << "Hoisting loop-invariant divisors...\n";
+    s = hoist_loop_invariant_divisors(s);
+    debug(2) << "Lowering after hoisting loop-invariant divisors:\n" << s << "\n\n";
+
+    debug(1) << "Marking non-temporal stores...\n";
+    s = inject_nontemporal_stores(s, env);
+    debug(2) << "Lowering after marking non-temporal stores:\n" << s << "\n\n";
+
     debug(1) << "Splitting off Hexagon offload...\n";
     s = inject_hexagon_rpc(s, t);
     debug(2) << "Lowering after splitting off Hexagon offload:\n" << s << '\n';
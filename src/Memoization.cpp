@@ -574,7 +574,7 @@ private:
                 body = Allocate::make(allocation->name, allocation->type, allocation->extents, allocation->condition, body,
                                       Call::make(Handle(), Call::buffer_get_host,
                                                  { Variable::make(type_of<struct buffer_t *>(), allocation->name + ".buffer") }, Call::Extern),
-                                      "halide_memoization_cache_release");
+                                      "halide_memoization_cache_release", allocation->memory_type);
             }
 
             pending_memoized_allocations.erase(innermost_realization_name);
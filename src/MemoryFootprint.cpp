@@ -0,0 +1,271 @@
+#include <set>
+
+#include "MemoryFootprint.h"
+#include "Bounds.h"
+#include "CodeGen_Internal.h"
+#include "Debug.h"
+#include "IRVisitor.h"
+#include "IROperator.h"
+#include "Scope.h"
+#include "Simplify.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Check if an Expr can be evaluated given only the names in
+// scope. Loads and impure calls can't be, because the memory they
+// refer to doesn't exist until the pipeline runs.
+class IsComputable : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    const set<string> &defined;
+    Scope<int> lets;
+
+    void visit(const Load *op) {
+        result = false;
+    }
+
+    void visit(const Call *op) {
+        if (op->call_type != Call::PureExtern &&
+            op->call_type != Call::PureIntrinsic) {
+            result = false;
+        } else {
+            IRGraphVisitor::visit(op);
+        }
+    }
+
+    void visit(const Variable *op) {
+        if (!defined.count(op->name) && !lets.contains(op->name)) {
+            result = false;
+        }
+    }
+
+    void visit(const Let *op) {
+        op->value.accept(this);
+        lets.push(op->name, 0);
+        op->body.accept(this);
+        lets.pop(op->name);
+    }
+
+public:
+    bool result = true;
+    IsComputable(const set<string> &d) : defined(d) {}
+};
+
+// Products and sums that stay unbounded (undefined) if either side
+// is.
+Expr add_bounds(Expr a, Expr b) {
+    return (a.defined() && b.defined()) ? a + b : Expr();
+}
+
+Expr mul_bounds(Expr a, Expr b) {
+    return (a.defined() && b.defined()) ? a * b : Expr();
+}
+
+Expr max_bounds(Expr a, Expr b) {
+    return (a.defined() && b.defined()) ? max(a, b) : Expr();
+}
+
+class BoundMemoryFootprint : public IRVisitor {
+    using IRVisitor::visit;
+
+    Scope<Interval> scope;
+
+    // The names the bounds may refer to: the symbols the code
+    // generator defines for the arguments, and the lets we hoist.
+    set<string> defined;
+
+    // An upper bound on the heap memory in use at any one time
+    // within the statement last visited. Undefined if unbounded.
+    Expr heap;
+
+    Expr heap_of(Stmt s) {
+        heap = make_zero(UInt(64));
+        s.accept(this);
+        return heap;
+    }
+
+    bool is_computable(Expr e) {
+        IsComputable check(defined);
+        e.accept(&check);
+        return check.result;
+    }
+
+    // An upper bound on a non-negative integer, as a uint64.
+    Expr upper_bound(Expr e) {
+        Interval i = bounds_of_expr_in_scope(e, scope);
+        if (!i.has_upper_bound() || !is_computable(i.max)) {
+            return Expr();
+        }
+        return cast<uint64_t>(max(i.max, 0));
+    }
+
+    void visit(const LetStmt *op) {
+        // Allocation sizes only depend on integer values.
+        Interval i = Interval::everything();
+        Type t = op->value.type();
+        if (t.is_int() || t.is_uint()) {
+            i = bounds_of_expr_in_scope(op->value, scope);
+        }
+        if (i.is_single_point() && is_computable(i.min)) {
+            // The value doesn't depend on any loop variable, so it
+            // can be computed up front, under a fresh name in case
+            // this one is reused in another part of the pipeline.
+            string name = unique_name(op->name);
+            lets.push_back({name, i.min});
+            defined.insert(name);
+            scope.push(op->name, Interval::single_point(Variable::make(i.min.type(), name)));
+        } else {
+            scope.push(op->name, i);
+        }
+        op->body.accept(this);
+        scope.pop(op->name);
+    }
+
+    void visit(const For *op) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            heap = make_zero(UInt(64));
+            return;
+        }
+
+        Interval min_bounds = bounds_of_expr_in_scope(op->min, scope);
+        Interval extent_bounds = bounds_of_expr_in_scope(op->extent, scope);
+        Interval var_bounds = Interval::everything();
+        if (min_bounds.has_lower_bound()) {
+            var_bounds.min = min_bounds.min;
+        }
+        if (min_bounds.has_upper_bound() && extent_bounds.has_upper_bound()) {
+            var_bounds.max = min_bounds.max + extent_bounds.max - 1;
+        }
+
+        scope.push(op->name, var_bounds);
+        Expr body = heap_of(op->body);
+        scope.pop(op->name);
+
+        if (op->for_type == ForType::Parallel) {
+            heap = mul_bounds(body, upper_bound(op->extent));
+        } else {
+            // Anything allocated inside a serial loop is freed
+            // before the next iteration.
+            heap = body;
+        }
+    }
+
+    void visit(const Block *op) {
+        // Allocations made in the first statement are freed by the
+        // time the second one runs.
+        Expr first = heap_of(op->first);
+        Expr rest = heap_of(op->rest);
+        heap = max_bounds(first, rest);
+    }
+
+    void visit(const IfThenElse *op) {
+        Expr then_case = heap_of(op->then_case);
+        Expr else_case = make_zero(UInt(64));
+        if (op->else_case.defined()) {
+            else_case = heap_of(op->else_case);
+        }
+        heap = max_bounds(then_case, else_case);
+    }
+
+    void visit(const Allocate *op) {
+        Expr body = heap_of(op->body);
+
+        // Decide between the stack and the heap the same way
+        // CodeGen_Posix::create_allocation does.
+        int32_t constant_size = Allocate::constant_allocation_size(op->extents, op->name);
+        int64_t stack_bytes = (int64_t)constant_size * op->type.bytes();
+        if (!op->new_expr.defined() &&
+            (op->extents.empty() ||
+             (constant_size > 0 && can_allocation_fit_on_stack(stack_bytes, op->memory_type)))) {
+            stack += op->extents.empty() ? op->type.bytes() : stack_bytes;
+            heap = body;
+            return;
+        }
+
+        if (is_zero(simplify(op->condition))) {
+            heap = body;
+            return;
+        }
+
+        Expr size = make_const(UInt(64), op->type.bytes());
+        for (Expr extent : op->extents) {
+            size = mul_bounds(size, upper_bound(extent));
+        }
+        if (!op->new_expr.defined()) {
+            // Heap allocations are padded by one element.
+            size = add_bounds(size, make_const(UInt(64), op->type.bytes()));
+        }
+        heap = add_bounds(size, body);
+    }
+
+public:
+    // Lets that the bounds depend on, in the order they must be
+    // defined.
+    vector<pair<string, Expr>> lets;
+
+    // The total size of the stack allocations.
+    uint64_t stack = 0;
+
+    BoundMemoryFootprint(const vector<Argument> &args) {
+        for (const Argument &arg : args) {
+            if (arg.is_buffer()) {
+                for (int i = 0; i < arg.dimensions; i++) {
+                    defined.insert(arg.name + ".min." + std::to_string(i));
+                    defined.insert(arg.name + ".extent." + std::to_string(i));
+                    defined.insert(arg.name + ".stride." + std::to_string(i));
+                }
+                defined.insert(arg.name + ".elem_size");
+            } else {
+                defined.insert(arg.name);
+            }
+        }
+    }
+
+    Expr peak_heap(Stmt s) {
+        return heap_of(s);
+    }
+};
+
+}  // namespace
+
+Stmt memory_footprint_query(Stmt s, const vector<Argument> &args,
+                            const string &result_name) {
+    BoundMemoryFootprint bounds(args);
+    Expr heap = bounds.peak_heap(s);
+    if (!heap.defined()) {
+        debug(1) << "Could not bound the heap usage of " << result_name << "\n";
+        heap = UInt(64).max();
+    }
+    Expr stack = make_const(UInt(64), bounds.stack);
+
+    // The result buffer may be strided, so step by its stride to
+    // get to the second element.
+    Expr stride = Variable::make(Int(32), result_name + ".stride.0");
+    Stmt result = Block::make(Store::make(result_name, heap, 0, Parameter(), const_true()),
+                              Store::make(result_name, stack, stride, Parameter(), const_true()));
+
+    // Check there's room for both results.
+    Expr min = Variable::make(Int(32), result_name + ".min.0");
+    Expr extent = Variable::make(Int(32), result_name + ".extent.0");
+    Expr error = Call::make(Int(32), "halide_error_access_out_of_bounds",
+                            {"Output buffer " + result_name, 0, min, min + 1, min, min + extent - 1},
+                            Call::Extern);
+    result = Block::make(AssertStmt::make(extent >= 2, error), result);
+    for (size_t i = bounds.lets.size(); i > 0; i--) {
+        result = LetStmt::make(bounds.lets[i - 1].first, bounds.lets[i - 1].second, result);
+    }
+    return simplify(result);
+}
+
+}
+}
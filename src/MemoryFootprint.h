@@ -0,0 +1,33 @@
+#ifndef HALIDE_MEMORY_FOOTPRINT_H
+#define HALIDE_MEMORY_FOOTPRINT_H
+
+/** \file
+ * Defines the pass that builds a query for the memory a pipeline will
+ * use, without running it.
+ */
+
+#include "IR.h"
+#include "Argument.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Given the lowered statement for a pipeline, build a statement that
+ * computes upper bounds on the memory one invocation of it uses, from
+ * the arguments only, and stores them as uint64s to the first two
+ * elements of the buffer named result_name: the peak number of bytes
+ * allocated on the heap at any one time, and the total size of the
+ * stack allocations. Iterations of parallel loops are assumed to all
+ * run at once. Allocations made on a device are not counted. If the
+ * heap usage can't be bounded (e.g. because an allocation's size
+ * depends on the contents of a buffer), it is reported as the largest
+ * uint64. Must be run on the fully lowered statement, as it mirrors
+ * the code generator's choice of heap or stack for each
+ * allocation. */
+Stmt memory_footprint_query(Stmt s, const std::vector<Argument> &args,
+                            const std::string &result_name);
+
+}
+}
+
+#endif
@@ -339,6 +339,14 @@ void compile_multitarget(const std::string &fn_name,
     TemporaryObjectFileDir temp_dir;
     std::vector<Expr> wrapper_args;
     std::vector<LoweredArgument> base_target_args;
+
+    // Pipelines also come with a function that bounds their memory
+    // use (see Pipeline::memory_footprint), which needs a wrapper of
+    // its own. Matlab targets don't get one.
+    const std::string footprint_fn_name = fn_name + "_memory_footprint";
+    bool has_footprint = !base_target.has_feature(Target::Matlab);
+    std::vector<Expr> footprint_wrapper_args;
+    std::vector<LoweredArgument> footprint_args;
     for (const Target &target : targets) {
         // arch-bits-os must be identical across all targets.
         if (target.os != base_target.os ||
@@ -384,6 +392,16 @@ void compile_multitarget(const std::string &fn_name,
         // but base_target is always the last one we encounter.
         base_target_args = sub_module.get_function_by_name(sub_fn_name).args;
 
+        const std::string sub_footprint_fn_name = sub_fn_name + "_memory_footprint";
+        bool sub_has_footprint = false;
+        for (const auto &f : sub_module.functions()) {
+            if (f.name == sub_footprint_fn_name) {
+                footprint_args = f.args;
+                sub_has_footprint = true;
+            }
+        }
+        has_footprint = has_footprint && sub_has_footprint;
+
         Outputs sub_out = add_suffixes(output_files, suffix);
         internal_assert(sub_out.object_name.empty());
         sub_out.object_name = temp_dir.add_temp_object_file(output_files.static_library_name, suffix, target);
@@ -403,6 +421,8 @@ void compile_multitarget(const std::string &fn_name,
 
         wrapper_args.push_back(can_use != 0);
         wrapper_args.push_back(sub_fn_name);
+        footprint_wrapper_args.push_back(can_use != 0);
+        footprint_wrapper_args.push_back(sub_footprint_fn_name);
     }
 
     // If we haven't specified "no runtime", build a runtime with the base target
@@ -428,11 +448,16 @@ void compile_multitarget(const std::string &fn_name,
     }
 
     if (needs_wrapper) {
-        Expr indirect_result = Call::make(Int(32), Call::call_cached_indirect_function, wrapper_args, Call::Intrinsic);
-        std::string private_result_name = unique_name(fn_name + "_result");
-        Expr private_result_var = Variable::make(Int(32), private_result_name);
-        Stmt wrapper_body = AssertStmt::make(private_result_var == 0, private_result_var);
-        wrapper_body = LetStmt::make(private_result_name, indirect_result, wrapper_body);
+        // Call the first sub-function whose target features are
+        // available, and pass on any error it returns.
+        auto make_wrapper_body = [](const std::string &name, const std::vector<Expr> &args) {
+            Expr indirect_result = Call::make(Int(32), Call::call_cached_indirect_function, args, Call::Intrinsic);
+            std::string private_result_name = unique_name(name + "_result");
+            Expr private_result_var = Variable::make(Int(32), private_result_name);
+            Stmt body = AssertStmt::make(private_result_var == 0, private_result_var);
+            return LetStmt::make(private_result_name, indirect_result, body);
+        };
+        Stmt wrapper_body = make_wrapper_body(fn_name, wrapper_args);
 
         // Always build with NoRuntime: that's handled as a separate module.
         //
@@ -456,6 +481,10 @@ void compile_multitarget(const std::string &fn_name,
 
         Module wrapper_module(fn_name, wrapper_target);
         wrapper_module.append(LoweredFunc(fn_name, base_target_args, wrapper_body, LoweredFunc::External));
+        if (has_footprint) {
+            Stmt footprint_body = make_wrapper_body(footprint_fn_name, footprint_wrapper_args);
+            wrapper_module.append(LoweredFunc(footprint_fn_name, footprint_args, footprint_body, LoweredFunc::External));
+        }
         Outputs wrapper_out = Outputs().object(
             temp_dir.add_temp_object_file(output_files.static_library_name, "_wrapper", base_target, /* in_front*/ true));
         futures.emplace_back(pool.async([](Module m, Outputs o) {
@@ -467,6 +496,9 @@ void compile_multitarget(const std::string &fn_name,
     if (!output_files.c_header_name.empty()) {
         Module header_module(fn_name, base_target);
         header_module.append(LoweredFunc(fn_name, base_target_args, {}, LoweredFunc::External));
+        if (has_footprint) {
+            header_module.append(LoweredFunc(footprint_fn_name, footprint_args, {}, LoweredFunc::External));
+        }
         Outputs header_out = Outputs().c_header(output_files.c_header_name);
         futures.emplace_back(pool.async([](Module m, Outputs o) {
             debug(1) << "compile_multitarget: c_header_name " << o.c_header_name << "\n";
@@ -0,0 +1,65 @@
+#include "NontemporalStores.h"
+#include "Function.h"
+#include "IRMutator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+class InjectNontemporalStores : public IRMutator {
+    const map<string, Function> &env;
+
+    using IRMutator::visit;
+
+    void visit(const For *op) {
+        // Leave device code alone.
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            stmt = op;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const ProducerConsumer *op) {
+        IRMutator::visit(op);
+        if (!op->is_producer) {
+            return;
+        }
+        auto it = env.find(op->name);
+        if (it == env.end() || !it->second.schedule().store_nontemporal()) {
+            return;
+        }
+        const Function &f = it->second;
+        vector<Expr> args;
+        if (f.outputs() == 1) {
+            args.push_back(f.name());
+        } else {
+            for (int i = 0; i < f.outputs(); i++) {
+                args.push_back(f.name() + "." + std::to_string(i));
+            }
+        }
+        const ProducerConsumer *pc = stmt.as<ProducerConsumer>();
+        internal_assert(pc);
+        Stmt marker = Evaluate::make(Call::make(Int(32), Call::nontemporal_stores,
+                                                args, Call::Intrinsic));
+        stmt = ProducerConsumer::make_produce(pc->name, Block::make(marker, pc->body));
+    }
+
+public:
+    InjectNontemporalStores(const map<string, Function> &e) : env(e) {}
+};
+
+}  // namespace
+
+Stmt inject_nontemporal_stores(Stmt s, const map<string, Function> &env) {
+    return InjectNontemporalStores(env).mutate(s);
+}
+
+}
+}
@@ -0,0 +1,29 @@
+#ifndef HALIDE_NONTEMPORAL_STORES_H
+#define HALIDE_NONTEMPORAL_STORES_H
+
+/** \file
+ * Defines the lowering pass that marks the Funcs whose stores should
+ * bypass the cache.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Tag the produce node of every Func scheduled with
+ * store_nontemporal with a call to the nontemporal_stores intrinsic
+ * naming its buffers. Backends that support streaming stores use this
+ * to emit them for dense vector stores to those buffers, and to fence
+ * them once the Func has been computed. Device loops are left
+ * alone. */
+Stmt inject_nontemporal_stores(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
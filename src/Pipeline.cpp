@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "Pipeline.h"
 #include "Argument.h"
@@ -7,8 +9,10 @@
 #include "LLVM_Headers.h"
 #include "LLVM_Output.h"
 #include "Lower.h"
+#include "MemoryFootprint.h"
 #include "Outputs.h"
 #include "PrintLoopNest.h"
+#include "ThreadPool.h"
 
 using namespace Halide::Internal;
 
@@ -85,6 +89,9 @@ struct PipelineContents {
     // JIT custom overrides
     JITHandlers jit_handlers;
 
+    // Where heap allocations come from when jitting, if not malloc.
+    Runtime::ScratchMemory *scratch_memory{nullptr};
+
     /** The user context that's used when jitting. This is not
      * settable by user code, but is reserved for internal use.  Note
      * that this is an Argument + Parameter (rather than a
@@ -569,10 +576,11 @@ Module Pipeline::compile_to_module(const vector<Argument> &args,
     const Module &old_module = contents->module;
     if (!old_module.functions().empty() &&
         old_module.target() == target) {
-        internal_assert(old_module.functions().size() == 2);
+        internal_assert(old_module.functions().size() >= 2);
         // We can avoid relowering and just reuse the private body
-        // from the old module. We expect two functions in the old
-        // module: the private one then the public one.
+        // from the old module. We expect the private function to come
+        // first, then the public one, then the memory footprint
+        // query.
         private_body = old_module.functions().front().body;
         debug(2) << "Reusing old module\n";
     } else {
@@ -627,6 +635,18 @@ Module Pipeline::compile_to_module(const vector<Argument> &args,
 
     module.append(LoweredFunc(new_fn_name, public_args, public_body, linkage_type));
 
+    // Add a function that computes bounds on the memory the pipeline
+    // will use, from the same arguments plus a buffer to put the
+    // bounds in.
+    if (!target.has_feature(Target::Matlab)) {
+        const string footprint_name = "_memory_footprint";
+        vector<Argument> footprint_args = public_args;
+        footprint_args.push_back(Argument(footprint_name, Argument::OutputBuffer, UInt(64), 1));
+        Stmt footprint_body = memory_footprint_query(private_body, public_args, footprint_name);
+        module.append(LoweredFunc(new_fn_name + "_memory_footprint", footprint_args,
+                                  footprint_body, linkage_type));
+    }
+
     contents->module = module;
 
     return module;
@@ -685,7 +705,8 @@ void *Pipeline::compile_jit(const Target &target_arg) {
 
     std::map<std::string, JITExtern> lowered_externs = contents->jit_externs;
     // Compile to jit module
-    JITModule jit_module(module, f, make_externs_jit_module(target_arg, lowered_externs));
+    JITModule jit_module(module, f, make_externs_jit_module(target_arg, lowered_externs),
+                         {name + "_memory_footprint_argv"});
 
     // Dump bitcode to a file if the environment variable
     // HL_GENBITCODE is defined to a nonzero value.
@@ -717,6 +738,11 @@ void Pipeline::set_custom_allocator(void *(*cust_malloc)(void *, size_t),
     contents->jit_handlers.custom_free = cust_free;
 }
 
+void Pipeline::set_scratch_memory(Runtime::ScratchMemory *scratch) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    contents->scratch_memory = scratch;
+}
+
 void Pipeline::set_custom_do_par_for(int (*cust_do_par_for)(void *, int (*)(void *, int, uint8_t *), int, int, uint8_t *)) {
     user_assert(defined()) << "Pipeline is undefined\n";
     contents->jit_handlers.custom_do_par_for = cust_do_par_for;
@@ -866,13 +892,24 @@ struct ErrorBuffer {
     }
 };
 
+void *scratch_malloc_handler(void *ctx, size_t size) {
+    return ((JITUserContext *)ctx)->scratch_memory->allocate(size);
+}
+
+void scratch_free_handler(void *ctx, void *ptr) {
+    if (ptr) {
+        ((JITUserContext *)ctx)->scratch_memory->release(ptr);
+    }
+}
+
 struct JITFuncCallContext {
     ErrorBuffer error_buffer;
     JITUserContext jit_context;
     Parameter &user_context_param;
     bool custom_error_handler;
 
-    JITFuncCallContext(const JITHandlers &handlers, Parameter &user_context_param)
+    JITFuncCallContext(const JITHandlers &handlers, Parameter &user_context_param,
+                       Runtime::ScratchMemory *scratch_memory = nullptr)
         : user_context_param(user_context_param) {
         void *user_context = nullptr;
         JITHandlers local_handlers = handlers;
@@ -883,7 +920,12 @@ struct JITFuncCallContext {
         } else {
             custom_error_handler = true;
         }
+        if (scratch_memory) {
+            local_handlers.custom_malloc = scratch_malloc_handler;
+            local_handlers.custom_free = scratch_free_handler;
+        }
         JITSharedRuntime::init_jit_user_context(jit_context, user_context, local_handlers);
+        jit_context.scratch_memory = scratch_memory;
         user_context_param.set_scalar(&jit_context);
 
         debug(2) << "custom_print: " << (void *)jit_context.handlers.custom_print << '\n'
@@ -1109,7 +1151,8 @@ void Pipeline::realize(Realization dst, const Target &t) {
     // user_context is just a pointer to a JITUserContext, which is a
     // member of the JITFuncCallContext which we will declare now:
 
-    JITFuncCallContext jit_context(jit_handlers(), contents->user_context_arg.param);
+    JITFuncCallContext jit_context(jit_handlers(), contents->user_context_arg.param,
+                                   contents->scratch_memory);
 
     // The handlers in the jit_context default to the default handlers
     // in the runtime of the shared module (e.g. halide_print_impl,
@@ -1171,6 +1214,186 @@ void Pipeline::realize(Realization dst, const Target &t) {
     jit_context.finalize(exit_status);
 }
 
+namespace {
+
+struct BatchJob {
+    int (*argv_function)(const void **);
+    const void **args;
+    size_t num_args;
+};
+
+int realize_batch_task(void *user_context, int idx, uint8_t *closure) {
+    BatchJob *job = (BatchJob *)closure;
+    return job->argv_function(job->args + idx * job->num_args);
+}
+
+}  // namespace
+
+void Pipeline::realize_batch(const vector<Realization> &dst,
+                             const std::map<string, vector<Buffer<>>> &inputs,
+                             const Target &t) {
+    Target target = t;
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+
+    if (dst.empty()) {
+        return;
+    }
+
+    if (target.os == Target::OSUnknown) {
+        if (contents->jit_module.compiled()) {
+            target = contents->jit_target;
+        } else {
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    // Check the first item's outputs, compile, and marshal the
+    // arguments that all items share.
+    for (size_t k = 0; k < dst[0].size(); k++) {
+        user_assert(dst[0][k].data() != nullptr)
+            << "Buffer at " << &(dst[0][k]) << " is unallocated. "
+            << "The Buffers in the Realizations passed to realize_batch must all be allocated\n";
+    }
+    const vector<const void *> args = prepare_jit_call_arguments(dst[0], target);
+    const vector<InferredArgument> &inferred_args = contents->inferred_args;
+    const size_t num_inputs = inferred_args.size();
+    const size_t num_args = args.size();
+
+    // The rest of the items only need to match the first.
+    for (size_t j = 1; j < dst.size(); j++) {
+        user_assert(dst[j].size() == dst[0].size())
+            << "Item " << j << " of the batch passed to realize_batch has "
+            << dst[j].size() << " outputs instead of " << dst[0].size() << "\n";
+        for (size_t k = 0; k < dst[j].size(); k++) {
+            user_assert(dst[j][k].data() != nullptr)
+                << "Buffer at " << &(dst[j][k]) << " is unallocated. "
+                << "The Buffers in the Realizations passed to realize_batch must all be allocated\n";
+            user_assert(dst[j][k].type() == dst[0][k].type() &&
+                        dst[j][k].dimensions() == dst[0][k].dimensions())
+                << "Output " << k << " of item " << j << " of the batch passed to realize_batch "
+                << "doesn't have the same type and dimensionality as in item 0\n";
+        }
+    }
+
+    // Find the argument slot of each batched input.
+    vector<std::pair<size_t, const vector<Buffer<>> *>> batched;
+    for (const auto &in : inputs) {
+        size_t i = 0;
+        while (i < num_inputs &&
+               !(inferred_args[i].param.defined() &&
+                 inferred_args[i].param.is_buffer() &&
+                 inferred_args[i].param.name() == in.first)) {
+            i++;
+        }
+        user_assert(i < num_inputs)
+            << "realize_batch was given Buffers for " << in.first
+            << ", which is not an ImageParam used by this Pipeline\n";
+        user_assert(in.second.size() == dst.size())
+            << "realize_batch was given " << in.second.size()
+            << " Buffers for ImageParam " << in.first
+            << ", but the batch has " << dst.size() << " items\n";
+        const Parameter &p = inferred_args[i].param;
+        for (const Buffer<> &b : in.second) {
+            user_assert(b.defined() && b.data() != nullptr)
+                << "realize_batch was given an unallocated Buffer for ImageParam " << p.name() << "\n";
+            user_assert(b.type() == p.type() && b.dimensions() == p.dimensions())
+                << "Can't use Buffer " << b.name() << " for ImageParam " << p.name()
+                << " because the Buffer has type " << Type(b.type())
+                << " and " << b.dimensions() << " dimensions, but the ImageParam has type "
+                << p.type() << " and " << p.dimensions() << " dimensions\n";
+        }
+        batched.push_back({i, &in.second});
+    }
+
+    for (size_t i = 0; i < num_inputs; i++) {
+        if (args[i] == nullptr) {
+            bool found = false;
+            for (const auto &b : batched) {
+                found = found || b.first == i;
+            }
+            user_assert(found)
+                << "Can't realize a batch because ImageParam "
+                << inferred_args[i].param.name() << " is not bound to a Buffer "
+                << "and no Buffers were given for it\n";
+        }
+    }
+
+    // Marshal every item's arguments up front.
+    vector<const void *> batch_args(num_args * dst.size());
+    for (size_t j = 0; j < dst.size(); j++) {
+        const void **item_args = &batch_args[j * num_args];
+        std::copy(args.begin(), args.end(), item_args);
+        for (const auto &b : batched) {
+            item_args[b.first] = (*b.second)[j].raw_buffer();
+        }
+        for (size_t k = 0; k < dst[j].size(); k++) {
+            item_args[num_inputs + k] = dst[j][k].raw_buffer();
+        }
+    }
+
+    // All items share one call context. Its error buffer can be
+    // appended to from several threads at once.
+    JITFuncCallContext jit_context(jit_handlers(), contents->user_context_arg.param,
+                                   contents->scratch_memory);
+
+    BatchJob job = {contents->jit_module.argv_function(), &batch_args[0], num_args};
+
+    typedef int (*do_par_for_fn)(void *, halide_task_t, int, int, uint8_t *);
+    do_par_for_fn do_par_for =
+        (do_par_for_fn)contents->jit_module.find_symbol_by_name("halide_do_par_for").address;
+
+    int exit_status = 0;
+    if (do_par_for) {
+        exit_status = do_par_for(&jit_context.jit_context, realize_batch_task,
+                                 0, (int)dst.size(), (uint8_t *)&job);
+    } else {
+        for (size_t j = 0; j < dst.size() && exit_status == 0; j++) {
+            exit_status = realize_batch_task(&jit_context.jit_context, (int)j, (uint8_t *)&job);
+        }
+    }
+
+    jit_context.finalize(exit_status);
+}
+
+MemoryFootprint Pipeline::memory_footprint(Realization dst, const Target &t) {
+    Target target = t;
+    user_assert(defined()) << "Can't query the memory footprint of an undefined Pipeline\n";
+
+    if (target.os == Target::OSUnknown) {
+        if (contents->jit_module.compiled()) {
+            target = contents->jit_target;
+        } else {
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    vector<const void *> args = prepare_jit_call_arguments(dst, target);
+
+    for (size_t i = 0; i < contents->inferred_args.size(); i++) {
+        const InferredArgument &arg = contents->inferred_args[i];
+        if (arg.param.defined()) {
+            user_assert(args[i] != nullptr)
+                << "Can't query the memory footprint of a pipeline because ImageParam "
+                << arg.param.name() << " is not bound to a Buffer\n";
+        }
+    }
+
+    // The query function takes the same arguments as the pipeline,
+    // then a buffer for the result.
+    Buffer<uint64_t> result(2);
+    args.push_back(result.raw_buffer());
+
+    JITModule::Symbol query =
+        contents->jit_module.find_symbol_by_name(generate_function_name() + "_memory_footprint_argv");
+    internal_assert(query.address);
+
+    JITFuncCallContext jit_context(jit_handlers(), contents->user_context_arg.param);
+    int exit_status = ((int (*)(const void **))query.address)(&(args[0]));
+    jit_context.finalize(exit_status);
+
+    return {result(0), result(1)};
+}
+
 void Pipeline::infer_input_bounds(Realization dst) {
 
     Target target = get_jit_target_from_environment();
@@ -1278,6 +1501,238 @@ void Pipeline::infer_input_bounds(int x_size, int y_size, int z_size, int w_size
     infer_input_bounds(r);
 }
 
+namespace {
+
+// Split [min, min + extent) into intervals of the given size. A
+// leftover interval of less than half a tile is merged into the one
+// before it, so that pipelines scheduled with splits aren't asked for
+// slivers narrower than their split factors.
+vector<std::pair<int, int>> split_into_tiles(int min, int extent, int tile) {
+    vector<std::pair<int, int>> result;
+    if (tile <= 0 || tile >= extent) {
+        result.push_back({min, extent});
+        return result;
+    }
+    for (int x = 0; x < extent; x += tile) {
+        int size = std::min(tile, extent - x);
+        if (size * 2 < tile) {
+            result.back().second += size;
+        } else {
+            result.push_back({min + x, size});
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+void Pipeline::realize_tiled(Realization dst, const vector<int> &tile_size,
+                             InputTileFn fill_input, int num_threads,
+                             const Target &t) {
+    Target target = t;
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+
+    const int dims = dst[0].dimensions();
+    for (size_t i = 0; i < dst.size(); i++) {
+        user_assert(dst[i].data() != nullptr)
+            << "Buffer at " << &(dst[i]) << " is unallocated. "
+            << "The Buffers in a Realization passed to realize_tiled must all be allocated\n";
+        bool same_shape = dst[i].dimensions() == dims;
+        for (int d = 0; same_shape && d < dims; d++) {
+            same_shape = (dst[i].dim(d).min() == dst[0].dim(d).min() &&
+                          dst[i].dim(d).extent() == dst[0].dim(d).extent());
+        }
+        user_assert(same_shape)
+            << "The Buffers in a Realization passed to realize_tiled must all have the same shape\n";
+    }
+    user_assert((int)tile_size.size() <= dims)
+        << "Can't tile a " << dims << "-dimensional output with a "
+        << tile_size.size() << "-dimensional tile size\n";
+
+    if (target.os == Target::OSUnknown) {
+        if (contents->jit_module.compiled()) {
+            target = contents->jit_target;
+        } else {
+            target = get_jit_target_from_environment();
+        }
+    }
+    user_assert(!target.has_gpu_feature())
+        << "realize_tiled only supports host targets, not " << target.to_string() << "\n";
+
+    // Compile the pipeline, and find the inputs that each tile will
+    // have to fill in.
+    const vector<const void *> args = prepare_jit_call_arguments(dst, target);
+    const vector<InferredArgument> &inferred_args = contents->inferred_args;
+    const size_t num_inputs = inferred_args.size();
+    const size_t user_context_index = num_inputs - 1;
+    internal_assert(inferred_args[user_context_index].param.same_as(contents->user_context_arg.param));
+
+    vector<size_t> unbound;
+    for (size_t i = 0; i < num_inputs; i++) {
+        if (args[i] == nullptr) {
+            unbound.push_back(i);
+        }
+    }
+    user_assert(unbound.empty() || fill_input)
+        << "Can't realize a pipeline tile by tile because ImageParam "
+        << (unbound.empty() ? "" : inferred_args[unbound[0]].param.name())
+        << " is not bound to a Buffer, and no callback was given to fill it in\n";
+
+    vector<vector<std::pair<int, int>>> splits(dims);
+    size_t num_tiles = 1;
+    for (int d = 0; d < dims; d++) {
+        int tile = d < (int)tile_size.size() ? tile_size[d] : 0;
+        splits[d] = split_into_tiles(dst[0].dim(d).min(), dst[0].dim(d).extent(), tile);
+        num_tiles *= splits[d].size();
+    }
+
+    if (num_threads <= 0) {
+        num_threads = (int)ThreadPool<void>::num_processors_online();
+    }
+    num_threads = (int)std::max<size_t>(1, std::min<size_t>(num_threads, num_tiles));
+
+    // Each worker gets its own call context, so that errors are
+    // collected per worker, and its own copies of the outputs to crop.
+    // The contexts are made here, because constructing one binds the
+    // shared user_context Param. The workers pass a pointer to their
+    // context directly instead of reading that Param.
+    vector<std::unique_ptr<JITFuncCallContext>> contexts;
+    vector<void *> user_contexts;
+    vector<vector<Runtime::Buffer<>>> outputs(num_threads);
+    for (int w = 0; w < num_threads; w++) {
+        contexts.emplace_back(new JITFuncCallContext(jit_handlers(), contents->user_context_arg.param,
+                                                     contents->scratch_memory));
+        user_contexts.push_back(&contexts.back()->jit_context);
+        for (size_t i = 0; i < dst.size(); i++) {
+            outputs[w].push_back(*dst[i].get());
+        }
+    }
+    vector<int> exit_status(num_threads, 0);
+
+    const int max_iters = 16;
+    std::atomic<size_t> next_tile(0);
+    std::atomic<bool> failed(false), converged(true);
+
+    auto worker = [&](int w) {
+        int (*argv_function)(const void **) = contents->jit_module.argv_function();
+        vector<const void *> tile_args = args;
+        tile_args[user_context_index] = &user_contexts[w];
+
+        // The memory backing the windows of the unbound inputs. It's
+        // reallocated only when a tile needs a larger window.
+        vector<Runtime::Buffer<>> storage(num_inputs);
+
+        size_t tile;
+        while (!failed && (tile = next_tile++) < num_tiles) {
+            vector<Runtime::Buffer<>> tile_outputs;
+            size_t idx = tile;
+            for (size_t i = 0; i < dst.size(); i++) {
+                tile_outputs.push_back(outputs[w][i]);
+            }
+            for (int d = 0; d < dims; d++) {
+                const std::pair<int, int> &s = splits[d][idx % splits[d].size()];
+                idx /= splits[d].size();
+                for (Runtime::Buffer<> &out : tile_outputs) {
+                    out.crop(d, s.first, s.second);
+                }
+            }
+            for (size_t i = 0; i < tile_outputs.size(); i++) {
+                tile_args[num_inputs + i] = tile_outputs[i].raw_buffer();
+            }
+
+            // Ask the pipeline which region of each unbound input this
+            // tile needs.
+            vector<Runtime::Buffer<>> query(num_inputs), orig(num_inputs);
+            for (size_t i : unbound) {
+                const Parameter &p = inferred_args[i].param;
+                query[i] = Runtime::Buffer<>(p.type(), nullptr, vector<int>(p.dimensions(), 0));
+                tile_args[i] = query[i].raw_buffer();
+            }
+            bool changed = !unbound.empty();
+            for (int iter = 0; changed; iter++) {
+                if (iter == max_iters) {
+                    converged = false;
+                    failed = true;
+                    return;
+                }
+                for (size_t i : unbound) {
+                    orig[i] = query[i];
+                }
+                int status = argv_function(&(tile_args[0]));
+                if (status) {
+                    exit_status[w] = status;
+                    failed = true;
+                    return;
+                }
+                changed = false;
+                for (size_t i : unbound) {
+                    for (int d = 0; d < query[i].dimensions(); d++) {
+                        if (query[i].dim(d).min() != orig[i].dim(d).min() ||
+                            query[i].dim(d).extent() != orig[i].dim(d).extent() ||
+                            query[i].dim(d).stride() != orig[i].dim(d).stride()) {
+                            changed = true;
+                        }
+                    }
+                }
+            }
+
+            // Place a window of that shape in the storage for each
+            // unbound input, and have the callback fill it in.
+            vector<Buffer<>> windows(num_inputs);
+            for (size_t i : unbound) {
+                const Runtime::Buffer<> &q = query[i];
+                if (storage[i].data() == nullptr ||
+                    q.size_in_bytes() > storage[i].size_in_bytes()) {
+                    storage[i] = q;
+                    storage[i].allocate();
+                }
+                vector<halide_dimension_t> shape(q.dimensions());
+                ptrdiff_t offset = 0;
+                for (int d = 0; d < q.dimensions(); d++) {
+                    shape[d].min = q.dim(d).min();
+                    shape[d].extent = q.dim(d).extent();
+                    shape[d].stride = q.dim(d).stride();
+                    if (shape[d].stride < 0) {
+                        offset -= (ptrdiff_t)shape[d].stride * (shape[d].extent - 1);
+                    }
+                }
+                uint8_t *host = (uint8_t *)storage[i].begin() + offset * q.type().bytes();
+                windows[i] = Buffer<>(Runtime::Buffer<>(q.type(), host, q.dimensions(), &shape[0]),
+                                      inferred_args[i].param.name());
+                fill_input(inferred_args[i].param.name(), windows[i]);
+                tile_args[i] = windows[i].raw_buffer();
+            }
+
+            int status = argv_function(&(tile_args[0]));
+            if (status) {
+                exit_status[w] = status;
+                failed = true;
+                return;
+            }
+        }
+    };
+
+    {
+        ThreadPool<void> pool(num_threads);
+        vector<std::future<void>> done;
+        for (int w = 0; w < num_threads; w++) {
+            done.push_back(pool.async(worker, w));
+        }
+        for (std::future<void> &f : done) {
+            f.wait();
+        }
+    }
+
+    for (int w = 0; w < num_threads; w++) {
+        contexts[w]->finalize(exit_status[w]);
+    }
+
+    user_assert(converged)
+        << "Inferring input bounds for a tile of Pipeline"
+        << " didn't converge after " << max_iters
+        << " iterations. There may be unsatisfiable constraints\n";
+}
+
 void Pipeline::invalidate_cache() {
     if (defined()) {
         contents->invalidate_cache();
@@ -7,6 +7,7 @@
  * pipeline.
  */
 
+#include <functional>
 #include <vector>
 
 #include "IntrusivePtr.h"
@@ -14,6 +15,7 @@
 #include "Module.h"
 #include "Tuple.h"
 #include "Target.h"
+#include "runtime/HalideScratchMemory.h"
 
 namespace Halide {
 
@@ -51,6 +53,18 @@ struct CustomLoweringPass {
 
 struct JITExtern;
 
+/** Upper bounds on the memory used by one realization of a
+ * Pipeline. See Pipeline::memory_footprint. */
+struct MemoryFootprint {
+    /** The most memory allocated on the heap at any one time, in
+     * bytes. */
+    uint64_t heap_bytes;
+
+    /** The total size of the stack allocations, in bytes. No thread
+     * uses more stack than this for the pipeline's own buffers. */
+    uint64_t stack_bytes;
+};
+
 /** A class representing a Halide pipeline. Constructed from the Func
  * or Funcs that it outputs. */
 class Pipeline {
@@ -184,7 +198,18 @@ public:
                                                       const std::vector<Target> &targets);
 
     /** Create an internal representation of lowered code as a self
-     * contained Module suitable for further compilation. */
+     * contained Module suitable for further compilation.
+     *
+     * Alongside the pipeline itself, the Module contains a function
+     * named fn_name + "_memory_footprint", which takes the same
+     * arguments followed by a one-dimensional uint64 buffer of at
+     * least two elements. It doesn't run the pipeline; it writes to
+     * the buffer upper bounds on the peak heap memory and on the
+     * stack memory per thread, in bytes, that running it with those
+     * arguments would use. The output buffers only need a shape, not
+     * an allocation. See Pipeline::memory_footprint for what's
+     * counted. (Not emitted for Matlab targets, which can only have
+     * one entry point per object.) */
     EXPORT Module compile_to_module(const std::vector<Argument> &args,
                                     const std::string &fn_name,
                                     const Target &target = get_target_from_environment(),
@@ -226,6 +251,16 @@ public:
     EXPORT void set_custom_allocator(void *(*malloc)(void *, size_t),
                                      void (*free)(void *, void *));
 
+    /** Make realizations of this Pipeline allocate the heap memory for
+     * intermediate Funcs from the given ScratchMemory, instead of
+     * calling malloc and free on each call. The first realization
+     * populates it, and later realizations of the same size reuse its
+     * blocks without allocating anything. This overrides any allocator
+     * set with set_custom_allocator. Pass nullptr to stop using
+     * it. The ScratchMemory is not owned by the Pipeline, and must
+     * outlive any realizations that use it. */
+    EXPORT void set_scratch_memory(Runtime::ScratchMemory *scratch);
+
     /** Set a custom task handler to be called by the parallel for
      * loop. It is useful to set this if you want to do some
      * additional bookkeeping at the granularity of parallel
@@ -365,6 +400,33 @@ public:
      * back from the GPU. */
     EXPORT void realize(Realization dst, const Target &target = Target());
 
+    /** Evaluate this Pipeline once for each of a batch of outputs, as
+     * a single parallel job on the runtime's thread pool. This is much
+     * cheaper than calling realize in a loop when each realization is
+     * small. inputs maps the names of ImageParams to the Buffer to use
+     * for each item in the batch, and must cover every ImageParam that
+     * isn't bound to a Buffer. ImageParams that are bound and not in
+     * inputs, and all scalar Params, take the same value for every
+     * item. Arguments are checked and marshalled once for the whole
+     * batch. As with realize into a Realization, outputs are not
+     * copied back from the GPU. */
+    EXPORT void realize_batch(const std::vector<Realization> &dst,
+                              const std::map<std::string, std::vector<Buffer<>>> &inputs =
+                                  std::map<std::string, std::vector<Buffer<>>>(),
+                              const Target &target = Target());
+
+    /** Get upper bounds on the memory that realizing this Pipeline
+     * into the given buffers would use, without running it. Only the
+     * shapes of the buffers matter, so they don't need to be
+     * allocated (e.g. Buffer<float>((float *)nullptr, 1920, 1080)).
+     * All ImageParams must be bound. The bounds come from the
+     * allocation sizes found by bounds inference, and assume every
+     * iteration of a parallel loop runs at once. Allocations made on
+     * a GPU or other device are not counted. If an allocation size
+     * can't be bounded, e.g. because it depends on the contents of an
+     * input, heap_bytes is the largest uint64_t. */
+    EXPORT MemoryFootprint memory_footprint(Realization dst, const Target &target = Target());
+
     /** For a given size of output, or a given set of output buffers,
      * determine the bounds required of all unbound ImageParams
      * referenced. Communicates the result by allocating new buffers
@@ -375,6 +437,38 @@ public:
     EXPORT void infer_input_bounds(Realization dst);
     // @}
 
+    /** A callback used by realize_tiled to fill in the part of an
+     * unbound ImageParam that a tile needs. It's given the name of the
+     * ImageParam and an allocated Buffer whose mins and extents are
+     * the region required. It's called from worker threads, so it may
+     * run concurrently for different tiles, and it must not throw. */
+    typedef std::function<void(const std::string &, Buffer<>)> InputTileFn;
+
+    /** Evaluate this Pipeline into existing output buffers one tile at
+     * a time, for outputs too large to realize in one go. tile_size
+     * gives the extent of each tile in the leading dimensions of the
+     * output. Remaining dimensions are not tiled. A leftover strip of
+     * less than half a tile at the edge of the output is merged into
+     * the tile next to it, so that tiles are never much narrower than
+     * tile_size.
+     *
+     * Each tile's input requirements are found with bounds
+     * inference. ImageParams that are bound to a Buffer (which may be,
+     * for example, a memory-mapped file) are passed to every tile
+     * unchanged. For the unbound ones, a window of just the region the
+     * tile needs is allocated and filled in by fill_input. Windows are
+     * reused from one tile to the next, so the memory used grows with
+     * the tile size and number of threads, not with the size of the
+     * image.
+     *
+     * Tiles are realized on num_threads threads (one per core if
+     * num_threads is zero). The outputs must all have the same shape.
+     * Only host targets are supported. */
+    EXPORT void realize_tiled(Realization dst, const std::vector<int> &tile_size,
+                              InputTileFn fill_input = nullptr,
+                              int num_threads = 0,
+                              const Target &target = Target());
+
     /** Infer the arguments to the Pipeline, sorted into a canonical order:
      * all buffers (sorted alphabetically by name), followed by all non-buffers
      * (sorted alphabetically by name).
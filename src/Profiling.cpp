@@ -70,6 +70,7 @@ private:
     Expr compute_allocation_size(const vector<Expr> &extents,
                                  const Expr &condition,
                                  const Type &type,
+                                 MemoryType memory_type,
                                  const std::string &name,
                                  bool &on_stack) {
         on_stack = true;
@@ -82,7 +83,7 @@ private:
         int32_t constant_size = Allocate::constant_allocation_size(extents, name);
         if (constant_size > 0) {
             int64_t stack_bytes = constant_size * type.bytes();
-            if (can_allocation_fit_on_stack(stack_bytes)) { // Allocation on stack
+            if (can_allocation_fit_on_stack(stack_bytes, memory_type)) { // Allocation on stack
                 return make_const(UInt(64), stack_bytes);
             }
         }
@@ -112,7 +113,7 @@ private:
         Expr condition = mutate(op->condition);
 
         bool on_stack;
-        Expr size = compute_allocation_size(new_extents, condition, op->type, op->name, on_stack);
+        Expr size = compute_allocation_size(new_extents, condition, op->type, op->memory_type, op->name, on_stack);
         internal_assert(size.type() == UInt(64));
         func_alloc_sizes.push(op->name, {on_stack, size});
 
@@ -139,7 +140,7 @@ private:
             new_expr.same_as(op->new_expr)) {
             stmt = op;
         } else {
-            stmt = Allocate::make(op->name, op->type, new_extents, condition, body, new_expr, op->free_function);
+            stmt = Allocate::make(op->name, op->type, new_extents, condition, body, new_expr, op->free_function, op->memory_type);
         }
 
         if (!is_zero(size) && !on_stack && profiling_memory) {
@@ -80,8 +80,11 @@ struct ScheduleContents {
     bool memoized;
     bool touched;
     bool allow_race_conditions;
+    bool store_nontemporal;
+    MemoryType memory_type;
 
-    ScheduleContents() : memoized(false), touched(false), allow_race_conditions(false) {};
+    ScheduleContents() : memoized(false), touched(false), allow_race_conditions(false), store_nontemporal(false),
+                         memory_type(MemoryType::Auto) {};
 
     // Pass an IRMutator through to all Exprs referenced in the ScheduleContents
     void mutate(IRMutator *mutator) {
@@ -149,6 +152,8 @@ Schedule Schedule::deep_copy(
     copy.contents->memoized = contents->memoized;
     copy.contents->touched = contents->touched;
     copy.contents->allow_race_conditions = contents->allow_race_conditions;
+    copy.contents->store_nontemporal = contents->store_nontemporal;
+    copy.contents->memory_type = contents->memory_type;
 
     // Deep-copy wrapper functions. If function has already been deep-copied before,
     // i.e. it's in the 'copied_map', use the deep-copied version from the map instead
@@ -275,6 +280,22 @@ bool Schedule::allow_race_conditions() const {
     return contents->allow_race_conditions;
 }
 
+bool &Schedule::store_nontemporal() {
+    return contents->store_nontemporal;
+}
+
+bool Schedule::store_nontemporal() const {
+    return contents->store_nontemporal;
+}
+
+MemoryType &Schedule::memory_type() {
+    return contents->memory_type;
+}
+
+MemoryType Schedule::memory_type() const {
+    return contents->memory_type;
+}
+
 void Schedule::accept(IRVisitor *visitor) const {
     for (const ReductionVariable &r : rvars()) {
         if (r.min.defined()) {
@@ -59,6 +59,17 @@ enum class TailStrategy {
      * instead of a multiple of the split factor as with RoundUp. */
     ShiftInwards,
 
+    /** Guard the inner loop with an if statement like GuardWithIf,
+     * but if the inner loop is vectorized, handle the tail with a
+     * single vector iteration that uses predicated (masked) loads
+     * and stores, instead of a scalar epilogue. Always legal. Pros:
+     * no redundant re-evaluation, no constraints on input or output
+     * sizes, and no scalar code. Cons: the masked loads and stores
+     * are slower than plain ones on targets without native support
+     * for them (native support includes AVX2 for 32 and 64-bit
+     * types, and AVX-512). */
+    Predicate,
+
     /** For pure definitions use ShiftInwards. For pure vars in
      * update definitions use RoundUp. For RVars in update
      * definitions use GuardWithIf. */
@@ -190,6 +201,11 @@ struct Dim {
     enum Type {PureVar = 0, PureRVar, ImpureRVar};
     Type dim_type;
 
+    /** If true, this is the outer, parallel loop of a strip split
+     * created by parallel_strips. Funcs stored outside of it and
+     * computed within it get separate storage per strip. */
+    bool per_strip_storage;
+
     bool is_pure() const {return (dim_type == PureVar) || (dim_type == PureRVar);}
     bool is_rvar() const {return (dim_type == PureRVar) || (dim_type == ImpureRVar);}
     bool is_parallel() const {
@@ -340,6 +356,18 @@ public:
     bool &allow_race_conditions();
     // @}
 
+    /** Should dense vector stores to this function bypass the cache? */
+    // @{
+    bool store_nontemporal() const;
+    bool &store_nontemporal();
+    // @}
+
+    /** Where should the storage for this function be placed? */
+    // @{
+    MemoryType memory_type() const;
+    MemoryType &memory_type();
+    // @}
+
     /** Pass an IRVisitor through to all Exprs referenced in the
      * Schedule. */
     void accept(IRVisitor *) const;
@@ -4865,7 +4865,7 @@ private:
             // else case must not use it.
             stmt = Allocate::make(op->name, op->type, new_extents,
                                   condition, body_if->then_case,
-                                  new_expr, op->free_function);
+                                  new_expr, op->free_function, op->memory_type);
             stmt = IfThenElse::make(body_if->condition, stmt, body_if->else_case);
         } else if (all_extents_unmodified &&
                    body.same_as(op->body) &&
@@ -4875,7 +4875,7 @@ private:
         } else {
             stmt = Allocate::make(op->name, op->type, new_extents,
                                   condition, body,
-                                  new_expr, op->free_function);
+                                  new_expr, op->free_function, op->memory_type);
         }
     }
 
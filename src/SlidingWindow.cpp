@@ -1,3 +1,5 @@
+#include <set>
+
 #include "SlidingWindow.h"
 #include "IRMutator.h"
 #include "IROperator.h"
@@ -353,10 +355,114 @@ public:
     SlidingWindowOnFunction(Function f) : func(f) {}
 };
 
+// Count the references to a function (productions, consumptions,
+// and calls) in a statement.
+class CountFuncReferences : public IRVisitor {
+    const string &func;
+
+    using IRVisitor::visit;
+
+    void visit(const ProducerConsumer *op) {
+        if (op->name == func) count++;
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Provide *op) {
+        if (op->name == func) count++;
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Call *op) {
+        if (op->name == func) count++;
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Variable *op) {
+        if (op->name == func + ".buffer") count++;
+    }
+
+public:
+    int count = 0;
+    CountFuncReferences(const string &f) : func(f) {}
+};
+
+int count_func_references(Stmt s, const string &func) {
+    CountFuncReferences counter(func);
+    s.accept(&counter);
+    return counter.count;
+}
+
+// Move a realization into the body of a parallel loop created by
+// parallel_strips, if the function is only referenced within that
+// loop. Each strip then gets its own storage, and the function can
+// slide along the serial loop within the strip.
+class SinkRealizationIntoStrips : public IRMutator {
+    const Realize *realize;
+    const std::set<string> &strip_loops;
+    int references;
+
+    using IRMutator::visit;
+
+    // The sunk realization's bounds are the symbolic *_realized
+    // extents, which allocation bounds inference later computes from
+    // the box touched within the strip body. Only sink if that box
+    // is bounded and moves with the strip, so that each strip
+    // allocates its own footprint rather than the whole image (which
+    // would otherwise happen on every strip if storage folding then
+    // fails).
+    bool footprint_shrinks(const For *op) {
+        Box b = box_touched(op->body, realize->name);
+        bool depends_on_strip = false;
+        for (size_t i = 0; i < b.size(); i++) {
+            if (!b[i].is_bounded()) {
+                return false;
+            }
+            depends_on_strip = depends_on_strip ||
+                expr_depends_on_var(b[i].min, op->name) ||
+                expr_depends_on_var(b[i].max, op->name);
+        }
+        return depends_on_strip;
+    }
+
+    void visit(const For *op) {
+        if (!sunk &&
+            op->for_type == ForType::Parallel &&
+            strip_loops.count(op->name) &&
+            count_func_references(op->body, realize->name) == references) {
+            if (!footprint_shrinks(op)) {
+                user_warning << "Not giving " << realize->name
+                             << " separate storage per strip of " << op->name
+                             << ", because the region of it each strip uses"
+                             << " doesn't depend on the strip.\n";
+                stmt = op;
+                return;
+            }
+            debug(3) << "Sinking realization of " << realize->name
+                     << " into parallel strips over " << op->name << "\n";
+            Stmt body = Realize::make(realize->name, realize->types, realize->bounds,
+                                      realize->condition, op->body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            sunk = true;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    bool sunk = false;
+    SinkRealizationIntoStrips(const Realize *r, const std::set<string> &s) :
+        realize(r), strip_loops(s) {
+        references = count_func_references(r->body, r->name);
+    }
+};
+
 // Perform sliding window optimization for all functions
 class SlidingWindow : public IRMutator {
     const map<string, Function> &env;
 
+    // The names of the parallel loops created by parallel_strips
+    std::set<string> strip_loops;
+
     using IRMutator::visit;
 
     void visit(const Realize *op) {
@@ -378,6 +484,17 @@ class SlidingWindow : public IRMutator {
             return;
         }
 
+        if (!strip_loops.empty() && !sched.memoized()) {
+            SinkRealizationIntoStrips sinker(op, strip_loops);
+            Stmt sunk = sinker.mutate(op->body);
+            if (sinker.sunk) {
+                // Sliding window analysis happens on the new
+                // realization within the strips.
+                stmt = mutate(sunk);
+                return;
+            }
+        }
+
         Stmt new_body = op->body;
 
         debug(3) << "Doing sliding window analysis on realization of " << op->name << "\n";
@@ -393,7 +510,20 @@ class SlidingWindow : public IRMutator {
         }
     }
 public:
-    SlidingWindow(const map<string, Function> &e) : env(e) {}
+    SlidingWindow(const map<string, Function> &e) : env(e) {
+        for (const auto &p : env) {
+            const Function &f = p.second;
+            for (int i = 0; i <= (int)f.updates().size(); i++) {
+                const Definition &def = (i == 0) ? f.definition() : f.update(i - 1);
+                string prefix = f.name() + ".s" + std::to_string(i) + ".";
+                for (const Dim &d : def.schedule().dims()) {
+                    if (d.per_strip_storage) {
+                        strip_loops.insert(prefix + d.var);
+                    }
+                }
+            }
+        }
+    }
 
 };
 
@@ -101,10 +101,12 @@ private:
         realizations.pop(op->name);
 
         vector<int> storage_permutation;
+        MemoryType memory_type;
         {
             auto iter = env.find(op->name);
             internal_assert(iter != env.end()) << "Realize node refers to function not in environment.\n";
             Function f = iter->second.first;
+            memory_type = f.schedule().memory_type();
             const vector<StorageDim> &storage_dims = f.schedule().storage_dims();
             const vector<string> &args = f.args();
             for (size_t i = 0; i < storage_dims.size(); i++) {
@@ -159,7 +161,7 @@ private:
         }
 
         // Make the allocation node
-        stmt = Allocate::make(op->name, op->types[0], extents, condition, stmt);
+        stmt = Allocate::make(op->name, op->types[0], extents, condition, stmt, Expr(), std::string(), memory_type);
 
         // Compute the strides
         for (int i = (int)op->bounds.size()-1; i > 0; i--) {
@@ -321,7 +323,7 @@ class PromoteToMemoryType : public IRMutator {
             }
             stmt = Allocate::make(op->name, t, extents,
                                   mutate(op->condition), mutate(op->body),
-                                  mutate(op->new_expr), op->free_function);
+                                  mutate(op->new_expr), op->free_function, op->memory_type);
         } else {
             IRMutator::visit(op);
         }
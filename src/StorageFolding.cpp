@@ -50,14 +50,29 @@ int count_producers(Stmt in, const std::string &name) {
     return counter.count;
 }
 
-// Fold the storage of a function in a particular dimension by a particular factor
+// Fold the storage of a function in a particular dimension by a
+// particular factor. If the factor is known to be a power of two, the
+// coordinate is reduced with a mask instead of a modulus, because
+// non-constant power-of-two factors are otherwise invisible to the
+// simplifier and would turn into a division.
 class FoldStorageOfFunction : public IRMutator {
     string func;
     int dim;
     Expr factor;
+    bool power_of_two;
 
     using IRMutator::visit;
 
+    Expr fold(Expr arg) {
+        if (is_one(factor)) {
+            return 0;
+        } else if (power_of_two && !is_const(factor)) {
+            return arg & (factor - 1);
+        } else {
+            return arg % factor;
+        }
+    }
+
     void visit(const Call *op) {
         IRMutator::visit(op);
         op = expr.as<Call>();
@@ -65,7 +80,7 @@ class FoldStorageOfFunction : public IRMutator {
         if (op->name == func && op->call_type == Call::Halide) {
             vector<Expr> args = op->args;
             internal_assert(dim < (int)args.size());
-            args[dim] = is_one(factor) ? 0 : (args[dim] % factor);
+            args[dim] = fold(args[dim]);
             expr = Call::make(op->type, op->name, args, op->call_type,
                               op->func, op->value_index, op->image, op->param);
         }
@@ -77,14 +92,14 @@ class FoldStorageOfFunction : public IRMutator {
         internal_assert(op);
         if (op->name == func) {
             vector<Expr> args = op->args;
-            args[dim] = is_one(factor) ? 0 : (args[dim] % factor);
+            args[dim] = fold(args[dim]);
             stmt = Provide::make(op->name, op->values, args);
         }
     }
 
 public:
-    FoldStorageOfFunction(string f, int d, Expr e) :
-        func(f), dim(d), factor(e) {}
+    FoldStorageOfFunction(string f, int d, Expr e, bool p = false) :
+        func(f), dim(d), factor(e), power_of_two(p) {}
 };
 
 // Attempt to fold the storage of a particular function in a statement
@@ -103,6 +118,40 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
         }
     }
 
+    // The LetStmts and loops between the realization of the function
+    // and the loop currently being considered. A fold factor
+    // computed at runtime must be expressible outside of all of them.
+    vector<std::pair<string, Expr>> inner_lets;
+    Scope<int> inner_loops;
+
+    void visit(const LetStmt *op) {
+        inner_lets.push_back({op->name, op->value});
+        Stmt body = mutate(op->body);
+        inner_lets.pop_back();
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, op->value, body);
+        }
+    }
+
+    void record_failure(const string &loop, const string &reason) {
+        failures.push_back({loop, reason});
+    }
+
+    // Try to rewrite an upper bound on the footprint of the function
+    // in terms of things defined outside its realization. Returns an
+    // undefined Expr on failure.
+    Expr hoist_out_of_realization(Expr e) {
+        for (size_t i = inner_lets.size(); i > 0; i--) {
+            e = substitute(inner_lets[i-1].first, inner_lets[i-1].second, e);
+        }
+        if (expr_uses_vars(e, inner_loops)) {
+            return Expr();
+        }
+        return simplify(e);
+    }
+
     void visit(const For *op) {
         if (op->for_type != ForType::Serial && op->for_type != ForType::Unrolled) {
             // We can't proceed into a parallel for loop.
@@ -111,6 +160,15 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
             // by the threads as this loop counter varies
             // (i.e. there's no cross-talk between threads), then it's
             // safe to proceed.
+            Box box = box_touched(op->body, func.name());
+            for (size_t i = 0; i < box.size(); i++) {
+                if (box[i].min.defined() && box[i].max.defined() &&
+                    (expr_uses_var(box[i].min, op->name) ||
+                     expr_uses_var(box[i].max, op->name))) {
+                    record_failure(op->name, "it is stored outside of a parallel loop over which its footprint varies");
+                    break;
+                }
+            }
             stmt = op;
             return;
         }
@@ -180,6 +238,7 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
             if (min_monotonic_increasing || max_monotonic_decreasing) {
                 Expr extent = simplify(max - min + 1);
                 Expr factor;
+                Expr dynamic_factor;
                 if (explicit_factor.defined()) {
                     Expr error = Call::make(Int(32), "halide_error_fold_factor_too_small",
                                             {func.name(), storage_dim.var, explicit_factor, op->name, extent},
@@ -188,32 +247,64 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
 
                     factor = explicit_factor;
                 } else {
-                    // The max of the extent over all values of the loop variable must be a constant
+                    // The max of the extent over all values of the loop variable
                     Scope<Interval> scope;
                     scope.push(op->name, Interval(Variable::make(Int(32), op->name + ".loop_min"),
                                                   Variable::make(Int(32), op->name + ".loop_max")));
-                    Expr max_extent = simplify(bounds_of_expr_in_scope(extent, scope).max);
+                    Interval extent_bounds = bounds_of_expr_in_scope(extent, scope);
                     scope.pop(op->name);
 
-                    max_extent = find_constant_bound(max_extent, Direction::Upper);
+                    Expr max_extent;
+                    if (extent_bounds.has_upper_bound()) {
+                        max_extent = simplify(extent_bounds.max);
+                    }
 
                     const int max_fold = 1024;
-                    const int64_t *const_max_extent = as_const_int(max_extent);
+                    const int64_t *const_max_extent = nullptr;
+                    if (max_extent.defined()) {
+                        max_extent = find_constant_bound(max_extent, Direction::Upper);
+                        const_max_extent = as_const_int(max_extent);
+                    }
                     if (const_max_extent && *const_max_extent <= max_fold) {
                         factor = static_cast<int>(next_power_of_two(*const_max_extent));
+                    } else if (max_extent.defined() && !const_max_extent &&
+                               (dynamic_factor = hoist_out_of_realization(max_extent)).defined()) {
+                        // The extent is bounded, but not by a
+                        // constant. Round the bound up to a power of two
+                        // at runtime, outside the realization, and check
+                        // on every iteration that the footprint fits.
+                        debug(3) << "Folding by a dynamic factor bounded by " << dynamic_factor << "\n";
+                        Expr e = Halide::max(dynamic_factor, 1) - 1;
+                        dynamic_factor = make_const(Int(32), 1) << (32 - count_leading_zeros(e));
+                        string name = func.name() + "." + storage_dim.var + ".fold_factor";
+                        factor = Variable::make(Int(32), name);
+                        Expr error = Call::make(Int(32), "halide_error_fold_factor_too_small",
+                                                {func.name(), storage_dim.var, factor, op->name, extent},
+                                                Call::Extern);
+                        body = Block::make(AssertStmt::make(extent <= factor, error), body);
                     } else {
                         debug(3) << "Not folding because extent not bounded by a constant not greater than " << max_fold << "\n"
                                  << "extent = " << extent << "\n"
                                  << "max extent = " << max_extent << "\n";
+                        if (const_max_extent) {
+                            record_failure(op->name, "its footprint (" + std::to_string(*const_max_extent) +
+                                           ") exceeds the maximum automatic fold factor");
+                        } else if (max_extent.defined()) {
+                            record_failure(op->name, "the bound on its footprint depends on values "
+                                           "computed inside its realization");
+                        } else {
+                            record_failure(op->name, "its footprint is unbounded");
+                        }
                     }
                 }
 
                 if (factor.defined()) {
                     debug(3) << "Proceeding with factor " << factor << "\n";
 
-                    Fold fold = {(int)i - 1, factor};
+                    Fold fold = {(int)i - 1, factor, dynamic_factor};
                     dims_folded.push_back(fold);
-                    body = FoldStorageOfFunction(func.name(), (int)i - 1, factor).mutate(body);
+                    body = FoldStorageOfFunction(func.name(), (int)i - 1, factor,
+                                                 dynamic_factor.defined()).mutate(body);
 
                     Expr next_var = Variable::make(Int(32), op->name) + 1;
                     Expr next_min = substitute(op->name, next_var, min);
@@ -234,6 +325,14 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                 debug(3) << "Not folding because loop min or max not monotonic in the loop variable\n"
                          << "min = " << min << "\n"
                          << "max = " << max << "\n";
+                if (expr_uses_var(min, op->name) || expr_uses_var(max, op->name)) {
+                    if (explicit_only) {
+                        record_failure(op->name, "it has more than one producer, so only "
+                                       "explicit fold_storage directives are honored");
+                    } else {
+                        record_failure(op->name, "its footprint is not monotonic in the loop variable");
+                    }
+                }
             }
         }
 
@@ -241,7 +340,9 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
         // iteration to the next (which may happen due to sliding),
         // then we're safe to fold an inner loop.
         if (box_contains(provided, required)) {
+            inner_loops.push(op->name, 0);
             body = mutate(body);
+            inner_loops.pop(op->name);
         }
 
         if (body.same_as(op->body)) {
@@ -255,9 +356,18 @@ public:
     struct Fold {
         int dim;
         Expr factor;
+        // If the factor is only known at runtime, factor is a
+        // Variable and this is the value to bind it to outside the
+        // realization.
+        Expr dynamic_value;
     };
     vector<Fold> dims_folded;
 
+    struct Failure {
+        string loop, reason;
+    };
+    vector<Failure> failures;
+
     AttemptStorageFoldingOfFunction(Function f, bool explicit_only)
         : func(f), explicit_only(explicit_only) {}
 };
@@ -338,8 +448,33 @@ class StorageFolding : public IRMutator {
                 }
 
                 stmt = Realize::make(op->name, op->types, bounds, op->condition, body);
+
+                for (size_t i = 0; i < folder.dims_folded.size(); i++) {
+                    const Expr &value = folder.dims_folded[i].dynamic_value;
+                    if (value.defined()) {
+                        const Variable *var = folder.dims_folded[i].factor.as<Variable>();
+                        internal_assert(var);
+                        stmt = LetStmt::make(var->name, value, stmt);
+                    }
+                }
             }
+
+            if (folder.dims_folded.empty() && !folder.failures.empty()) {
+                report_failures(op->name, folder.failures);
+            }
+        }
+    }
+
+    void report_failures(const string &name,
+                         const vector<AttemptStorageFoldingOfFunction::Failure> &failures) {
+        std::ostringstream reasons;
+        for (const auto &f : failures) {
+            reasons << "  over loop " << f.loop << ": " << f.reason << "\n";
         }
+        debug(1) << "Could not fold storage of " << name << ":\n" << reasons.str();
+        user_warning << "Could not fold the storage of " << name
+                     << ", so it will be allocated at its full size:\n"
+                     << reasons.str();
     }
 
 public:
@@ -23,6 +23,13 @@ namespace Internal {
  *
  * We can store f as a circular buffer of size two, instead of
  * allocating space for all of it.
+ *
+ * If the footprint of f over the loop is bounded, but not by a
+ * constant (e.g. it depends on a Param), the fold factor is the
+ * bound rounded up to a power of two at runtime, and an assertion
+ * checks the footprint fits on every iteration. Functions that
+ * could not be folded over a loop along which their footprint
+ * moves are reported with a warning.
  */
 Stmt storage_folding(Stmt s, const std::map<std::string, Function> &env);
 
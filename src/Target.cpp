@@ -258,6 +258,8 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"avx512_knl", Target::AVX512_KNL},
     {"avx512_skylake", Target::AVX512_Skylake},
     {"avx512_cannonlake", Target::AVX512_Cannonlake},
+    {"loop_carry", Target::LoopCarry},
+    {"arm_fp16", Target::ARMFp16},
 };
 
 bool lookup_feature(const std::string &tok, Target::Feature &result) {
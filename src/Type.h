@@ -291,6 +291,7 @@ struct Type {
     static const halide_type_code_t UInt = halide_type_uint;
     static const halide_type_code_t Float = halide_type_float;
     static const halide_type_code_t Handle = halide_type_handle;
+    static const halide_type_code_t BFloat = halide_type_bfloat;
     // @}
 
     /** The number of bytes required to store a single scalar value of this type. Ignores vector lanes. */
@@ -362,8 +363,13 @@ struct Type {
      * TODO(abadams): Decide what to do for lanes() == 0. */
     bool is_scalar() const {return lanes() == 1;}
 
-    /** Is this type a floating point type (float or double). */
-    bool is_float() const {return code() == Float;}
+    /** Is this type a floating point type (float, double, or
+     * bfloat). */
+    bool is_float() const {return code() == Float || code() == BFloat;}
+
+    /** Is this type a bfloat? A bfloat has the same exponent range as
+     * a float of twice the width, with the mantissa truncated. */
+    bool is_bfloat() const {return code() == BFloat;}
 
     /** Is this type a signed integer type? */
     bool is_int() const {return code() == Int;}
@@ -435,6 +441,12 @@ inline Type Float(int bits, int lanes = 1) {
     return Type(Type::Float, bits, lanes);
 }
 
+/** Construct a bfloat type. Only 16 bits is supported: the upper
+ * half of a Float(32). Arithmetic on bfloats is done in Float(32). */
+inline Type BFloat(int bits, int lanes = 1) {
+    return Type(Type::BFloat, bits, lanes);
+}
+
 /** Construct a boolean type */
 inline Type Bool(int lanes = 1) {
     return UInt(1, lanes);
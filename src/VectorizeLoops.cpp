@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <set>
 
 #include "VectorizeLoops.h"
 #include "IRMutator.h"
@@ -13,6 +14,7 @@
 #include "Simplify.h"
 #include "CSE.h"
 #include "CodeGen_GPU_Dev.h"
+#include "Function.h"
 
 namespace Halide {
 namespace Internal {
@@ -240,11 +242,15 @@ class PredicateLoadStore : public IRMutator {
     int lanes;
     bool valid;
     bool vectorized;
+    bool force;
 
     using IRMutator::visit;
 
     bool should_predicate_store_load(int bit_size) {
-        if (in_hexagon) {
+        if (force) {
+            // The schedule asked for a predicated tail.
+            return true;
+        } else if (in_hexagon) {
             internal_assert(target.features_any_of({Target::HVX_64, Target::HVX_128}))
                 << "We are inside a hexagon loop, but the target doesn't have hexagon's features\n";
             return true;
@@ -338,9 +344,9 @@ class PredicateLoadStore : public IRMutator {
     }
 
 public:
-    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, const Target &t) :
+    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, const Target &t, bool force) :
             var(v), vector_predicate(vpred), in_hexagon(in_hexagon), target(t),
-            lanes(vpred.type().lanes()), valid(true), vectorized(false) {
+            lanes(vpred.type().lanes()), valid(true), vectorized(false), force(force) {
         internal_assert(lanes > 1);
     }
 
@@ -362,6 +368,9 @@ class VectorSubs : public IRMutator {
 
     bool in_hexagon; // Are we inside the hexagon loop?
 
+    // Was the loop split with TailStrategy::Predicate?
+    bool predicate_tail;
+
     // A suffix to attach to widened variables.
     string widening_suffix;
 
@@ -691,16 +700,22 @@ class VectorSubs : public IRMutator {
             bool vectorize_predicate = !uses_gpu_vars(cond);
             Stmt predicated_stmt;
             if (vectorize_predicate) {
-                PredicateLoadStore p(var, cond, in_hexagon, target);
+                PredicateLoadStore p(var, cond, in_hexagon, target, predicate_tail);
                 predicated_stmt = p.mutate(then_case);
                 vectorize_predicate = p.is_vectorized();
             }
             if (vectorize_predicate && else_case.defined()) {
-                PredicateLoadStore p(var, !cond, in_hexagon, target);
+                PredicateLoadStore p(var, !cond, in_hexagon, target, predicate_tail);
                 predicated_stmt = Block::make(predicated_stmt, p.mutate(else_case));
                 vectorize_predicate = p.is_vectorized();
             }
 
+            if (predicate_tail && !vectorize_predicate) {
+                user_warning << "Warning: Could not use predicated loads and stores "
+                             << "for the tail of the vectorized loop over " << var
+                             << ". It will be scalarized instead.\n";
+            }
+
             debug(4) << "IfThenElse should vectorize predicate over var " << var << "? " << vectorize_predicate << "; cond: " << cond << "\n";
             debug(4) << "Predicated stmt:\n" << predicated_stmt << "\n";
 
@@ -853,7 +868,7 @@ class VectorSubs : public IRMutator {
         // The variable itself could still exist inside an inner scalarized block.
         body = substitute(v, Variable::make(Int(32), var), body);
 
-        stmt = Allocate::make(op->name, op->type, new_extents, op->condition, body, new_expr, op->free_function);
+        stmt = Allocate::make(op->name, op->type, new_extents, op->condition, body, new_expr, op->free_function, op->memory_type);
     }
 
     Stmt scalarize(Stmt s) {
@@ -906,8 +921,8 @@ class VectorSubs : public IRMutator {
     }
 
 public:
-    VectorSubs(string v, Expr r, bool in_hexagon, const Target &t) :
-            var(v), replacement(r), target(t), in_hexagon(in_hexagon) {
+    VectorSubs(string v, Expr r, bool in_hexagon, const Target &t, bool predicate_tail) :
+            var(v), replacement(r), target(t), in_hexagon(in_hexagon), predicate_tail(predicate_tail) {
         widening_suffix = ".x" + std::to_string(replacement.type().lanes());
     }
 };
@@ -917,6 +932,10 @@ class VectorizeLoops : public IRMutator {
     const Target &target;
     bool in_hexagon;
 
+    // The names of loops that came from splits with
+    // TailStrategy::Predicate.
+    const std::set<string> &predicated_loops;
+
     using IRMutator::visit;
 
     void visit(const For *for_loop) {
@@ -937,7 +956,9 @@ class VectorizeLoops : public IRMutator {
             // Replace the var with a ramp within the body
             Expr for_var = Variable::make(Int(32), for_loop->name);
             Expr replacement = Ramp::make(for_loop->min, 1, extent->value);
-            stmt = VectorSubs(for_loop->name, replacement, in_hexagon, target).mutate(for_loop->body);
+            bool predicate_tail = predicated_loops.count(for_loop->name) > 0;
+            stmt = VectorSubs(for_loop->name, replacement, in_hexagon, target,
+                              predicate_tail).mutate(for_loop->body);
         } else {
             IRMutator::visit(for_loop);
         }
@@ -948,13 +969,50 @@ class VectorizeLoops : public IRMutator {
     }
 
 public:
-    VectorizeLoops(const Target &t) : target(t), in_hexagon(false) {}
+    VectorizeLoops(const Target &t, const std::set<string> &p) :
+        target(t), in_hexagon(false), predicated_loops(p) {}
 };
 
+// Find the loops created by splits with TailStrategy::Predicate,
+// along with any loops later split or renamed from them.
+std::set<string> find_predicated_loops(const std::map<string, Function> &env) {
+    std::set<string> result;
+    for (const auto &iter : env) {
+        const Function &f = iter.second;
+        if (!f.has_pure_definition()) {
+            continue;
+        }
+        for (size_t stage = 0; stage <= f.updates().size(); stage++) {
+            const Definition &def = stage == 0 ? f.definition() : f.update(stage - 1);
+            std::set<string> vars;
+            for (const Split &split : def.schedule().splits()) {
+                if (split.is_split() && split.tail == TailStrategy::Predicate) {
+                    vars.insert(split.inner);
+                } else if (split.is_fuse()) {
+                    if (vars.count(split.inner) || vars.count(split.outer)) {
+                        vars.insert(split.old_var);
+                    }
+                } else if (vars.count(split.old_var)) {
+                    vars.insert(split.outer);
+                    if (split.is_split()) {
+                        vars.insert(split.inner);
+                    }
+                }
+            }
+            string prefix = f.name() + ".s" + std::to_string(stage) + ".";
+            for (const string &v : vars) {
+                result.insert(prefix + v);
+            }
+        }
+    }
+    return result;
+}
+
 } // Anonymous namespace
 
-Stmt vectorize_loops(Stmt s, const Target &t) {
-    return VectorizeLoops(t).mutate(s);
+Stmt vectorize_loops(Stmt s, const std::map<string, Function> &env, const Target &t) {
+    std::set<string> predicated_loops = find_predicated_loops(env);
+    return VectorizeLoops(t, predicated_loops).mutate(s);
 }
 
 }
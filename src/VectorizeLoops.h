@@ -5,7 +5,10 @@
  * Defines the lowering pass that vectorizes loops marked as such
  */
 
+#include <map>
+
 #include "IR.h"
+#include "Function.h"
 #include "Target.h"
 
 namespace Halide {
@@ -13,9 +16,11 @@ namespace Internal {
 
 /** Take a statement with for loops marked for vectorization, and turn
  * them into single statements that operate on vectors. The loops in
- * question must have constant extent.
+ * question must have constant extent. Loops that came from splits
+ * with TailStrategy::Predicate always use predicated loads and stores
+ * for their tail.
  */
-Stmt vectorize_loops(Stmt s, const Target &t);
+Stmt vectorize_loops(Stmt s, const std::map<std::string, Function> &env, const Target &t);
 
 }
 }
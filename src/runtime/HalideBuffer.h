@@ -619,6 +619,20 @@ public:
         buf.host = (uint8_t *)((uintptr_t)(unaligned_ptr + alignment - 1) & ~(alignment - 1));
     }
 
+    /** Take shared ownership of memory that was allocated outside of
+     * this class (e.g. a memory-mapped file) and that contains the
+     * host memory this Buffer refers to. Drops the reference to any
+     * other owned memory. The header's reference count is
+     * incremented, and its deallocate_fn is called with the header
+     * when the last Buffer referring to it is destroyed. */
+    void adopt_allocation(AllocationHeader *header) {
+        uint8_t *host = buf.host;
+        deallocate();
+        buf.host = host;
+        alloc = header;
+        alloc->ref_count++;
+    }
+
     /** Drop reference to any owned memory, possibly freeing it, if
      * this buffer held the last reference to it. Retains the shape of
      * the buffer. Does nothing if this buffer did not allocate its
@@ -963,28 +977,28 @@ public:
         }
 
         // If T is void, we need to do runtime dispatch to an
-        // appropriately-typed lambda. We're copying, so we only care
+        // appropriately-typed copy. We're copying, so we only care
         // about the element size.
         if (type().bytes() == 1) {
             using MemType = uint8_t;
             auto &typed_dst = (Buffer<MemType, D> &)dst;
             auto &typed_src = (Buffer<const MemType, D> &)src;
-            typed_dst.for_each_value([&](MemType &dst, MemType src) {dst = src;}, typed_src);
+            Buffer<MemType, D>::copy_values(typed_dst, typed_src);
         } else if (type().bytes() == 2) {
             using MemType = uint16_t;
             auto &typed_dst = (Buffer<MemType, D> &)dst;
             auto &typed_src = (Buffer<const MemType, D> &)src;
-            typed_dst.for_each_value([&](MemType &dst, MemType src) {dst = src;}, typed_src);
+            Buffer<MemType, D>::copy_values(typed_dst, typed_src);
         } else if (type().bytes() == 4) {
             using MemType = uint32_t;
             auto &typed_dst = (Buffer<MemType, D> &)dst;
             auto &typed_src = (Buffer<const MemType, D> &)src;
-            typed_dst.for_each_value([&](MemType &dst, MemType src) {dst = src;}, typed_src);
+            Buffer<MemType, D>::copy_values(typed_dst, typed_src);
         } else if (type().bytes() == 8) {
             using MemType = uint64_t;
             auto &typed_dst = (Buffer<MemType, D> &)dst;
             auto &typed_src = (Buffer<const MemType, D> &)src;
-            typed_dst.for_each_value([&](MemType &dst, MemType src) {dst = src;}, typed_src);
+            Buffer<MemType, D>::copy_values(typed_dst, typed_src);
         } else {
             assert(false && "type().bytes() must be 1, 2, 4, or 8");
         }
@@ -1470,11 +1484,151 @@ public:
     // @}
 
     void fill(not_void_T val) {
-        for_each_value([=](T &v) {v = val;});
+        // If every byte of the value is the same (e.g. it's zero), and
+        // the buffer is dense in its innermost dimension, memset it.
+        const uint8_t *bytes = (const uint8_t *)(&val);
+        bool uniform_bytes = true;
+        for (size_t i = 1; i < sizeof(val); i++) {
+            uniform_bytes &= bytes[i] == bytes[0];
+        }
+        copy_task_dim t[D];
+        int d = make_copy_task(t, *this, (const Buffer<T, D> *)nullptr, sizeof(val));
+        if (uniform_bytes && d > 0 && t[0].dst_stride == (int64_t)sizeof(val)) {
+            fill_bytes_helper(t, d - 1, (uint8_t *)data(), bytes[0]);
+        } else {
+            for_each_value([=](T &v) {v = val;});
+        }
         set_host_dirty();
     }
 
 private:
+    /** Helper functions for copy_from and fill. */
+    // @{
+    struct copy_task_dim {
+        int extent;
+        // In bytes.
+        int64_t dst_stride, src_stride;
+    };
+
+    // Describe a copy from src to dst, which must have the same
+    // shape, as a loop nest. Dimensions of extent one are dropped,
+    // the rest are ordered by stride in dst so that the writes are
+    // cache-coherent, and dimensions that are contiguous in both
+    // buffers are collapsed together. src may be null for a
+    // fill. Returns the number of loops.
+    template<typename BufDst, typename BufSrc>
+    static int make_copy_task(copy_task_dim *t, const BufDst &dst, const BufSrc *src, int elem_size) {
+        int d = 0;
+        for (int i = 0; i < dst.dimensions(); i++) {
+            if (dst.dim(i).extent() == 1) {
+                continue;
+            }
+            t[d].extent = dst.dim(i).extent();
+            t[d].dst_stride = (int64_t)dst.dim(i).stride() * elem_size;
+            t[d].src_stride = src ? (int64_t)src->dim(i).stride() * elem_size : 0;
+            for (int j = d; j > 0 && t[j].dst_stride < t[j-1].dst_stride; j--) {
+                std::swap(t[j], t[j-1]);
+            }
+            d++;
+        }
+
+        for (int i = 1; i < d; i++) {
+            if (t[i-1].dst_stride * t[i-1].extent == t[i].dst_stride &&
+                t[i-1].src_stride * t[i-1].extent == t[i].src_stride) {
+                t[i-1].extent *= t[i].extent;
+                for (int j = i; j < d - 1; j++) {
+                    t[j] = t[j+1];
+                }
+                i--;
+                d--;
+            }
+        }
+        return d;
+    }
+
+    // Copy values where the innermost loop is dense in both buffers
+    // with memcpy, or, if transposed is true, where the innermost
+    // loop is dense in dst and the next one is dense in src. The
+    // latter is done in square tiles so that both the reads and the
+    // writes of a tile stay in cache.
+    template<typename MemType>
+    static void copy_helper(const copy_task_dim *t, int d, bool transposed,
+                            uint8_t *dst, const uint8_t *src) {
+        if (d == 0) {
+            memcpy(dst, src, t[0].extent * sizeof(MemType));
+        } else if (d == 1 && transposed) {
+            const int tile = 64 / sizeof(MemType) > 8 ? 64 / sizeof(MemType) : 8;
+            const copy_task_dim &x = t[0], &y = t[1];
+            for (int y0 = 0; y0 < y.extent; y0 += tile) {
+                int y1 = std::min(y0 + tile, y.extent);
+                for (int x0 = 0; x0 < x.extent; x0 += tile) {
+                    int x1 = std::min(x0 + tile, x.extent);
+                    for (int yi = y0; yi < y1; yi++) {
+                        MemType *dst_row = (MemType *)(dst + yi * y.dst_stride);
+                        const uint8_t *src_col = src + yi * y.src_stride;
+                        for (int xi = x0; xi < x1; xi++) {
+                            dst_row[xi] = *(const MemType *)(src_col + xi * x.src_stride);
+                        }
+                    }
+                }
+            }
+        } else {
+            for (int i = t[d].extent; i != 0; i--) {
+                copy_helper<MemType>(t, d - 1, transposed, dst, src);
+                dst += t[d].dst_stride;
+                src += t[d].src_stride;
+            }
+        }
+    }
+
+    static void fill_bytes_helper(const copy_task_dim *t, int d, uint8_t *dst, uint8_t val) {
+        if (d == 0) {
+            memset(dst, val, t[0].extent * t[0].dst_stride);
+        } else {
+            for (int i = t[d].extent; i != 0; i--) {
+                fill_bytes_helper(t, d - 1, dst, val);
+                dst += t[d].dst_stride;
+            }
+        }
+    }
+
+    // Copy the values of src into dst, which must have the same
+    // shape. Runs of values that are dense in both buffers are
+    // memcpy'd. If the two buffers are dense in different dimensions
+    // (e.g. one is a transpose of the other), the copy is done in
+    // tiles. Otherwise falls back to for_each_value.
+    template<typename MemType>
+    static void copy_values(Buffer<MemType, D> &dst, const Buffer<const MemType, D> &src) {
+        const int64_t size = sizeof(MemType);
+        copy_task_dim t[D];
+        int d = make_copy_task(t, dst, &src, size);
+        if (d == 0) {
+            // A single element.
+            *dst.data() = *src.data();
+            return;
+        }
+
+        bool transposed = false;
+        if (t[0].dst_stride == size && t[0].src_stride != size) {
+            for (int i = 1; i < d; i++) {
+                if (t[i].src_stride == size) {
+                    // The order of the outer loops doesn't matter, so
+                    // make this one the second-innermost.
+                    std::swap(t[1], t[i]);
+                    transposed = true;
+                    break;
+                }
+            }
+        }
+
+        if (t[0].dst_stride == size && (transposed || t[0].src_stride == size)) {
+            copy_helper<MemType>(t, d - 1, transposed, (uint8_t *)dst.data(), (const uint8_t *)src.data());
+        } else {
+            dst.for_each_value([&](MemType &dst, MemType src) {dst = src;}, src);
+        }
+    }
+    // @}
+
     /** Helper functions for for_each_value. */
     // @{
     template<int N>
@@ -1556,18 +1710,27 @@ public:
             t[i].extent = 1;
         }
 
+        int d = 0;
         for (int i = 0; i < dimensions(); i++) {
-            extract_strides(i, t[i].stride, this, &other_buffers...);
-            t[i].extent = dim(i).extent();
+            extract_strides(i, t[d].stride, this, &other_buffers...);
+            if (dim(i).extent() == 1) {
+                // No loop is needed, and its stride could stop the
+                // dimensions around it from being flattened.
+                for (int j = 0; j < N; j++) {
+                    t[d].stride[j] = 0;
+                }
+                continue;
+            }
+            t[d].extent = dim(i).extent();
             // Order the dimensions by stride, so that the traversal is cache-coherent.
-            for (int j = i; j > 0 && t[j].stride[0] < t[j-1].stride[0]; j--) {
+            for (int j = d; j > 0 && t[j].stride[0] < t[j-1].stride[0]; j--) {
                 std::swap(t[j], t[j-1]);
             }
+            d++;
         }
 
         // flatten dimensions where possible to make a larger inner
         // loop for autovectorization.
-        int d = dimensions();
         for (int i = 1; i < d; i++) {
             bool flat = true;
             for (int j = 0; j < N; j++) {
@@ -1584,7 +1747,7 @@ public:
         }
 
         bool innermost_strides_are_one = false;
-        if (dimensions() > 0) {
+        if (d > 0) {
             innermost_strides_are_one = true;
             for (int j = 0; j < N; j++) {
                 innermost_strides_are_one &= t[0].stride[j] == 1;
@@ -1788,6 +1951,145 @@ public:
         for_each_element(0, dimensions(), t, std::forward<Fn>(f));
     }
 
+private:
+    // Helper functions for the parallel variants of for_each_element
+    // and for_each_value.
+
+    /** The number of dimensions for_each_element will iterate over
+     * for a given callable, using the same overload tricks as
+     * for_each_element. */
+    template<typename Fn,
+             typename = decltype(std::declval<Fn>()((const int *)nullptr))>
+    static int num_iterated_dims(int, int dims, Fn &&) {
+        return dims;
+    }
+
+    template<typename Fn>
+    static int num_iterated_dims(double, int dims, Fn &&f) {
+        return num_args(0, std::forward<Fn>(f));
+    }
+
+    template<typename Task>
+    static int parallel_task_trampoline(void *user_context, int idx, uint8_t *closure) {
+        (*(Task *)closure)(idx);
+        return 0;
+    }
+
+    /** The default executor for the parallel variants. Runs the tasks
+     * on the Halide runtime's thread pool. */
+    struct halide_thread_pool_executor {
+        template<typename Task>
+        void operator()(int num_tasks, Task &task) const {
+            halide_do_par_for(nullptr, parallel_task_trampoline<Task>, 0, num_tasks, (uint8_t *)(&task));
+        }
+    };
+
+    /** Work out how many slices of dimension d of this buffer each
+     * task should take so that each task covers at least
+     * min_elements_per_task of the given dimensions. */
+    int64_t slices_per_task(int d, int dims, int min_elements_per_task) const {
+        int64_t slice_size = 1;
+        for (int i = 0; i < dims; i++) {
+            if (i != d) {
+                slice_size *= dim(i).extent();
+            }
+        }
+        if (slice_size == 0) {
+            return dim(d).extent();
+        }
+        return std::max((int64_t)1, (min_elements_per_task + slice_size - 1) / slice_size);
+    }
+
+public:
+    /** Call a function at each site in a buffer, like
+     * for_each_element, but split the work into tasks that may run
+     * concurrently. The outermost dimension the callable iterates
+     * over is divided into chunks containing at least
+     * min_elements_per_task sites each. The order in which sites are
+     * visited is unspecified, so the callable must be safe to call
+     * concurrently from several threads. Note that indexing a
+     * non-const Buffer marks it as dirty on the host, so to write
+     * values concurrently use for_each_value_parallel, or call
+     * set_host_dirty() first and index a const reference.
+     *
+     * By default the tasks are run on the Halide runtime's thread
+     * pool using halide_do_par_for, so this requires linking against
+     * the Halide runtime. Alternatively, pass an executor as the
+     * first argument. It will be called as executor(num_tasks, task),
+     * and must call task(i) for every i in [0, num_tasks) before
+     * returning. */
+    template<typename Fn>
+    void for_each_element_parallel(int min_elements_per_task, Fn &&f) const {
+        for_each_element_parallel(halide_thread_pool_executor(), min_elements_per_task, std::forward<Fn>(f));
+    }
+
+    template<typename Executor, typename Fn>
+    void for_each_element_parallel(Executor &&executor, int min_elements_per_task, Fn &&f) const {
+        int dims = num_iterated_dims(0, dimensions(), f);
+        int d = dims - 1;
+        while (d > 0 && dim(d).extent() == 1) {
+            d--;
+        }
+        int64_t chunk = d >= 0 ? slices_per_task(d, dims, min_elements_per_task) : 1;
+        int num_tasks = d >= 0 ? (int)((dim(d).extent() + chunk - 1) / chunk) : 1;
+        if (num_tasks <= 1) {
+            for_each_element(std::forward<Fn>(f));
+            return;
+        }
+
+        auto task = [&](int idx) {
+            for_each_element_task_dim t[D];
+            for (int i = 0; i < dimensions(); i++) {
+                t[i].min = dim(i).min();
+                t[i].max = dim(i).max();
+            }
+            t[d].min = (int)(dim(d).min() + idx * chunk);
+            t[d].max = (int)std::min((int64_t)dim(d).max(), t[d].min + chunk - 1);
+            for_each_element(0, dimensions(), t, f);
+        };
+        executor(num_tasks, task);
+    }
+
+    /** Call a function on every value in the buffer and the
+     * corresponding values in some number of other buffers, like
+     * for_each_value, but split the work into tasks that may run
+     * concurrently. The dimension with the largest stride in this
+     * buffer is divided into chunks containing at least
+     * min_elements_per_task values each. An executor may be passed
+     * as the first argument, as for for_each_element_parallel. */
+    template<typename Fn, typename ...Args>
+    void for_each_value_parallel(int min_elements_per_task, Fn &&f, Args... other_buffers) {
+        for_each_value_parallel(halide_thread_pool_executor(), min_elements_per_task,
+                                std::forward<Fn>(f), other_buffers...);
+    }
+
+    template<typename Executor, typename Fn, typename ...Args>
+    void for_each_value_parallel(Executor &&executor, int min_elements_per_task, Fn &&f, Args... other_buffers) {
+        int d = -1;
+        int64_t max_stride = 0;
+        for (int i = 0; i < dimensions(); i++) {
+            int64_t stride = dim(i).stride();
+            stride = stride < 0 ? -stride : stride;
+            if (dim(i).extent() > 1 && (d < 0 || stride > max_stride)) {
+                d = i;
+                max_stride = stride;
+            }
+        }
+        int64_t chunk = d >= 0 ? slices_per_task(d, dimensions(), min_elements_per_task) : 1;
+        int num_tasks = d >= 0 ? (int)((dim(d).extent() + chunk - 1) / chunk) : 1;
+        if (num_tasks <= 1) {
+            for_each_value(std::forward<Fn>(f), other_buffers...);
+            return;
+        }
+
+        auto task = [&](int idx) {
+            int min = (int)(dim(d).min() + idx * chunk);
+            int extent = (int)std::min(chunk, (int64_t)dim(d).max() - min + 1);
+            cropped(d, min, extent).for_each_value(f, other_buffers.cropped(d, min, extent)...);
+        };
+        executor(num_tasks, task);
+    }
+
 private:
     template<typename Fn>
     struct FillHelper {
@@ -0,0 +1,186 @@
+/** \file
+ * Defines a cache of the heap allocations made by Halide pipelines,
+ * so that a pipeline that is called repeatedly can reuse its scratch
+ * memory instead of allocating and freeing it on every call. */
+
+#ifndef HALIDE_RUNTIME_SCRATCH_MEMORY_H
+#define HALIDE_RUNTIME_SCRATCH_MEMORY_H
+
+#include <cassert>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "HalideRuntime.h"
+
+namespace Halide {
+namespace Runtime {
+
+/** Heap memory for the intermediate Funcs of a pipeline, kept between
+ * calls. Blocks that a pipeline frees are kept rather than returned to
+ * the system, and handed out again to later allocations that fit in
+ * them, so once a pipeline has run once (or the memory has been
+ * reserved up front), further calls of the same size perform no
+ * system allocations. Blocks are aligned to 128 bytes, like those from
+ * the default halide_malloc. It is safe to share one ScratchMemory
+ * between pipelines running concurrently.
+ *
+ * With the JIT, use Pipeline::set_scratch_memory. Ahead-of-time
+ * compiled pipelines call halide_malloc and halide_free with their
+ * user_context, so either pass a pointer to a ScratchMemory as the
+ * user_context and install the static halide_malloc and halide_free
+ * members below with halide_set_custom_malloc and
+ * halide_set_custom_free, or call allocate and release from your own
+ * versions of halide_malloc and halide_free.
+ */
+class ScratchMemory {
+    static const size_t alignment = 128;
+
+    struct Block {
+        void *orig, *ptr;
+        size_t size;
+        bool in_use;
+    };
+
+    std::mutex mutex;
+    std::vector<Block> blocks;
+    uint64_t system_allocations = 0;
+
+    // Halide may read up to 8 bytes either side of an allocation, so
+    // leave some slack around the aligned block.
+    static Block make_block(size_t size) {
+        Block b;
+        b.orig = malloc(size + alignment + 16);
+        b.ptr = (void *)(((uintptr_t)b.orig + 8 + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        b.size = size;
+        b.in_use = false;
+        return b;
+    }
+
+public:
+    ScratchMemory() = default;
+    ScratchMemory(const ScratchMemory &) = delete;
+    ScratchMemory &operator=(const ScratchMemory &) = delete;
+
+    ~ScratchMemory() {
+        for (const Block &b : blocks) {
+            assert(!b.in_use && "ScratchMemory destroyed while a pipeline was using it");
+            free(b.orig);
+        }
+    }
+
+    /** Get a block of at least the given size. The smallest free block
+     * that is large enough is used. If there isn't one, a new block is
+     * allocated, replacing the largest free block that was too small,
+     * so that the memory held stays bounded when allocation sizes
+     * grow. Returns nullptr if the system allocation fails. */
+    void *allocate(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Block *best = nullptr, *too_small = nullptr;
+        for (Block &b : blocks) {
+            if (b.in_use) continue;
+            if (b.size >= size) {
+                if (!best || b.size < best->size) {
+                    best = &b;
+                }
+            } else if (!too_small || b.size > too_small->size) {
+                too_small = &b;
+            }
+        }
+        if (!best) {
+            Block b = make_block(size);
+            if (!b.orig) {
+                return nullptr;
+            }
+            system_allocations++;
+            if (too_small) {
+                free(too_small->orig);
+                *too_small = b;
+                best = too_small;
+            } else {
+                blocks.push_back(b);
+                best = &blocks.back();
+            }
+        }
+        best->in_use = true;
+        return best->ptr;
+    }
+
+    /** Return a block obtained from allocate, keeping it for reuse. */
+    void release(void *ptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Block &b : blocks) {
+            if (b.ptr == ptr) {
+                assert(b.in_use && "Block released twice");
+                b.in_use = false;
+                return;
+            }
+        }
+        assert(false && "Released a block that did not come from this ScratchMemory");
+    }
+
+    /** Allocate count free blocks of the given size up front, e.g. from
+     * an upper bound on the sizes of a pipeline's allocations. */
+    void reserve(size_t size, int count = 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count; i++) {
+            Block b = make_block(size);
+            if (!b.orig) {
+                return;
+            }
+            system_allocations++;
+            blocks.push_back(b);
+        }
+    }
+
+    /** Free all blocks that are not currently in use. */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t kept = 0;
+        for (const Block &b : blocks) {
+            if (b.in_use) {
+                blocks[kept++] = b;
+            } else {
+                free(b.orig);
+            }
+        }
+        blocks.resize(kept);
+    }
+
+    /** The total size of the blocks held, in bytes. */
+    size_t size_in_bytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (const Block &b : blocks) {
+            total += b.size;
+        }
+        return total;
+    }
+
+    /** The number of blocks that have been allocated from the system
+     * over the lifetime of this object. */
+    uint64_t num_system_allocations() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return system_allocations;
+    }
+
+    /** Functions with the signatures of halide_malloc and halide_free
+     * that treat the user_context as a pointer to a ScratchMemory. */
+    // @{
+    static void *halide_malloc(void *user_context, size_t size) {
+        return ((ScratchMemory *)user_context)->allocate(size);
+    }
+
+    static void halide_free(void *user_context, void *ptr) {
+        if (ptr) {
+            ((ScratchMemory *)user_context)->release(ptr);
+        }
+    }
+    // @}
+};
+
+}  // namespace Runtime
+}  // namespace Halide
+
+#endif  // HALIDE_RUNTIME_SCRATCH_MEMORY_H
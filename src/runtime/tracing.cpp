@@ -143,6 +143,10 @@ WEAK int32_t default_trace(void *user_context, const halide_trace_event_t *e) {
                     }
                 } else if (e->type.code == 3) {
                     ss << ((void **)(e->value))[i];
+                } else if (e->type.code == 4) {
+                    // A bfloat16 is the top half of a float.
+                    uint32_t bits = (uint32_t)(((uint16_t *)(e->value))[i]) << 16;
+                    ss << reinterpret<float>(bits);
                 }
             }
             if (e->type.lanes > 1) {
@@ -0,0 +1,87 @@
+
+; The AVX-512BW byte and word intrinsics all take a passthrough
+; vector and a write mask. We always want every lane, so these
+; wrappers pass an all-ones mask.
+
+declare <64 x i8> @llvm.x86.avx512.mask.padds.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+declare <64 x i8> @llvm.x86.avx512.mask.psubs.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+declare <64 x i8> @llvm.x86.avx512.mask.paddus.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+declare <64 x i8> @llvm.x86.avx512.mask.psubus.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+declare <32 x i16> @llvm.x86.avx512.mask.padds.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <32 x i16> @llvm.x86.avx512.mask.psubs.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <32 x i16> @llvm.x86.avx512.mask.paddus.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <32 x i16> @llvm.x86.avx512.mask.psubus.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <64 x i8> @llvm.x86.avx512.mask.pavg.b.512(<64 x i8>, <64 x i8>, <64 x i8>, i64)
+declare <32 x i16> @llvm.x86.avx512.mask.pavg.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <32 x i16> @llvm.x86.avx512.mask.pmulh.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <32 x i16> @llvm.x86.avx512.mask.pmulhu.w.512(<32 x i16>, <32 x i16>, <32 x i16>, i32)
+declare <16 x i32> @llvm.x86.avx512.mask.pmaddw.d.512(<32 x i16>, <32 x i16>, <16 x i32>, i16)
+
+define weak_odr <64 x i8> @paddsbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.padds.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+define weak_odr <64 x i8> @psubsbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.psubs.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+define weak_odr <64 x i8> @paddusbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.paddus.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+define weak_odr <64 x i8> @psubusbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.psubus.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+define weak_odr <32 x i16> @paddswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.padds.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <32 x i16> @psubswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.psubs.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <32 x i16> @padduswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.paddus.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <32 x i16> @psubuswx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.psubus.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <64 x i8> @pavgbx64(<64 x i8> %a, <64 x i8> %b) nounwind alwaysinline {
+  %1 = tail call <64 x i8> @llvm.x86.avx512.mask.pavg.b.512(<64 x i8> %a, <64 x i8> %b, <64 x i8> undef, i64 -1)
+  ret <64 x i8> %1
+}
+
+define weak_odr <32 x i16> @pavgwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.pavg.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <32 x i16> @pmulhwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.pmulh.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+define weak_odr <32 x i16> @pmulhuwx32(<32 x i16> %a, <32 x i16> %b) nounwind alwaysinline {
+  %1 = tail call <32 x i16> @llvm.x86.avx512.mask.pmulhu.w.512(<32 x i16> %a, <32 x i16> %b, <32 x i16> undef, i32 -1)
+  ret <32 x i16> %1
+}
+
+; Called by the x86 backend as pmaddwd with four args, via the same
+; name-mangling as the narrower versions in x86.ll.
+define weak_odr <16 x i32> @pmaddwdx16(<16 x i16> %a, <16 x i16> %b, <16 x i16> %c, <16 x i16> %d) nounwind alwaysinline {
+  %1 = shufflevector <16 x i16> %a, <16 x i16> %c, <32 x i32> <i32 0, i32 16, i32 1, i32 17, i32 2, i32 18, i32 3, i32 19, i32 4, i32 20, i32 5, i32 21, i32 6, i32 22, i32 7, i32 23, i32 8, i32 24, i32 9, i32 25, i32 10, i32 26, i32 11, i32 27, i32 12, i32 28, i32 13, i32 29, i32 14, i32 30, i32 15, i32 31>
+  %2 = shufflevector <16 x i16> %b, <16 x i16> %d, <32 x i32> <i32 0, i32 16, i32 1, i32 17, i32 2, i32 18, i32 3, i32 19, i32 4, i32 20, i32 5, i32 21, i32 6, i32 22, i32 7, i32 23, i32 8, i32 24, i32 9, i32 25, i32 10, i32 26, i32 11, i32 27, i32 12, i32 28, i32 13, i32 29, i32 14, i32 30, i32 15, i32 31>
+  %3 = tail call <16 x i32> @llvm.x86.avx512.mask.pmaddw.d.512(<32 x i16> %1, <32 x i16> %2, <16 x i32> undef, i16 -1)
+  ret <16 x i32> %3
+}
@@ -368,6 +368,31 @@ bool test_all(int vector_width, Target t) {
             vector_width, t);
     }
 
+    // padded_copy:
+    {
+        const int32_t test_min = -25;
+        const int32_t test_extent = 100;
+
+        const uint8_t exterior = 42;
+
+        success &= check_repeat_edge(
+            input,
+            padded_copy(repeat_edge(input, 0, W, 0, H)),
+            test_min, test_extent, test_min, test_extent,
+            vector_width, t);
+        success &= check_constant_exterior(
+            input, exterior,
+            padded_copy(constant_exterior(input_f, exterior, 0, W, 0, H)),
+            test_min, test_extent, test_min, test_extent,
+            vector_width, t);
+        // A vector size that doesn't divide the region.
+        success &= check_mirror_image(
+            input,
+            padded_copy(mirror_image(input), 64),
+            test_min, test_extent, test_min, test_extent,
+            vector_width, t);
+    }
+
     return success;
 }
 
@@ -0,0 +1,114 @@
+// Don't include Halide.h: it is not necessary for this test.
+#include "HalideBuffer.h"
+#include "halide_buffer_file.h"
+#include "test/common/halide_test_dirs.h"
+
+#include <stdio.h>
+
+using namespace Halide::Runtime;
+using namespace Halide::Tools;
+
+int main(int argc, char **argv) {
+    std::string dir = Halide::Internal::get_test_tmp_dir();
+
+    {
+        // Round-trip a buffer with a non-zero min and a non-dense
+        // memory layout.
+        Buffer<float> a(30, 20, 3);
+        a.transpose(0, 2);
+        a.set_min(-5, 3, 10);
+        a.fill([&](int c, int y, int x) {return x + 100.0f * y + 10000.0f * c;});
+
+        std::string filename = dir + "buffer_file_float.hbuf";
+        if (!save_buffer_file(a, filename)) {
+            printf("Failed to save %s\n", filename.c_str());
+            return -1;
+        }
+
+        Buffer<const float> b = map_buffer_file<const float>(filename);
+        if (b.dimensions() != 3) {
+            printf("Mapped buffer has %d dimensions\n", b.dimensions());
+            return -1;
+        }
+        if (((uintptr_t)b.data()) % 4096 != 0) {
+            printf("Mapped payload is not page-aligned\n");
+            return -1;
+        }
+        for (int i = 0; i < 3; i++) {
+            if (b.dim(i).min() != a.dim(i).min() || b.dim(i).extent() != a.dim(i).extent()) {
+                printf("Mapped buffer has the wrong shape in dimension %d\n", i);
+                return -1;
+            }
+        }
+        b.for_each_element([&](int c, int y, int x) {
+            if (b(c, y, x) != a(c, y, x)) {
+                printf("b(%d, %d, %d) = %f instead of %f\n", c, y, x, b(c, y, x), a(c, y, x));
+                abort();
+            }
+        });
+
+        // The mapping should outlive the Buffer it was returned in.
+        Buffer<const float> b_window = b.cropped(1, 5, 5);
+        b = Buffer<const float>();
+        if (b_window(-5, 5, 10) != a(-5, 5, 10)) {
+            printf("Mapping didn't outlive the original Buffer\n");
+            return -1;
+        }
+
+        // Writable mappings are copy-on-write.
+        Buffer<float> c = map_buffer_file<float>(filename);
+        c.fill(0.0f);
+        Buffer<const void> d = map_buffer_file<const void>(filename);
+        if (d.type() != halide_type_of<float>() || *(const float *)d.data() != a(-5, 3, 10)) {
+            printf("Writing to a mapped buffer changed the file\n");
+            return -1;
+        }
+
+        // Loading as the wrong type fails.
+        Buffer<int> e;
+        if (map_buffer_file(filename, &e)) {
+            printf("Mapping a float file as int should have failed\n");
+            return -1;
+        }
+    }
+
+    {
+        // Write a buffer a few rows at a time.
+        const int W = 100, H = 64;
+        std::string filename = dir + "buffer_file_stream.hbuf";
+        BufferFileWriter<> writer(filename, halide_type_of<uint16_t>(), {0, 0}, {W, H});
+        for (int y = 0; y < H; y += 8) {
+            Buffer<uint16_t> strip(W, 8);
+            strip.set_min(0, y);
+            strip.fill([&](int x, int y) {return (uint16_t)(x + y * W);});
+            if (!writer.write(strip)) {
+                printf("Failed to write strip at %d\n", y);
+                return -1;
+            }
+        }
+        if (!writer.close()) {
+            printf("Failed to close %s\n", filename.c_str());
+            return -1;
+        }
+
+        Buffer<uint16_t> b = map_buffer_file<uint16_t>(filename);
+        b.for_each_element([&](int x, int y) {
+            if (b(x, y) != (uint16_t)(x + y * W)) {
+                printf("b(%d, %d) = %d instead of %d\n", x, y, b(x, y), x + y * W);
+                abort();
+            }
+        });
+
+        // Writing out of order, or not finishing, fails.
+        BufferFileWriter<> bad_writer(filename, halide_type_of<uint16_t>(), {0, 0}, {W, H});
+        Buffer<uint16_t> strip(W, 8);
+        strip.set_min(0, 8);
+        if (bad_writer.write(strip) || bad_writer.close()) {
+            printf("Writing strips out of order should have failed\n");
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
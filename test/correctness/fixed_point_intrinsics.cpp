@@ -0,0 +1,141 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <limits>
+#include <random>
+
+using namespace Halide;
+
+template<typename T> struct Wider;
+template<> struct Wider<int8_t> { typedef int16_t type; };
+template<> struct Wider<uint8_t> { typedef uint16_t type; };
+template<> struct Wider<int16_t> { typedef int32_t type; };
+template<> struct Wider<uint16_t> { typedef uint32_t type; };
+template<> struct Wider<int32_t> { typedef int64_t type; };
+template<> struct Wider<uint32_t> { typedef uint64_t type; };
+
+// Reference implementations, done in a type wide enough not to overflow.
+template<typename T, typename W>
+T saturate(W v) {
+    if (v > (W)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    if (v < (W)std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+    return (T)v;
+}
+
+template<typename W>
+W round_shift_right(W v, int s) {
+    return s == 0 ? v : (W)((v >> s) + ((v >> (s - 1)) & 1));
+}
+
+// Check an expression against a reference, both vectorized and not.
+template<typename R, typename F>
+bool check(const char *name, const char *type_name, Expr e, Var x, int n, int vec, F reference) {
+    for (int vectorized = 0; vectorized < 2; vectorized++) {
+        Func f;
+        f(x) = e;
+        if (vectorized) {
+            f.vectorize(x, vec);
+        }
+        Buffer<R> out = f.realize(n);
+        for (int i = 0; i < n; i++) {
+            R correct = reference(i);
+            if (out(i) != correct) {
+                printf("%s on %s%s at %d: %lld instead of %lld\n",
+                       name, type_name, vectorized ? " (vectorized)" : "", i,
+                       (long long)out(i), (long long)correct);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename T>
+bool test(const char *type_name) {
+    typedef typename Wider<T>::type W;
+    const int bits = sizeof(T) * 8;
+    const int n = 1024;
+    const T t_min = std::numeric_limits<T>::min();
+    const T t_max = std::numeric_limits<T>::max();
+
+    Buffer<T> a_buf(n), b_buf(n);
+    Buffer<uint8_t> s_buf(n);
+    std::mt19937 rng(bits);
+    for (int i = 0; i < n; i++) {
+        a_buf(i) = (T)rng();
+        b_buf(i) = (T)rng();
+        s_buf(i) = (uint8_t)(rng() % bits);
+    }
+
+    // Make sure we hit the extremes.
+    a_buf(0) = t_min; b_buf(0) = t_min;
+    a_buf(1) = t_max; b_buf(1) = t_max;
+    a_buf(2) = t_min; b_buf(2) = t_max;
+    a_buf(3) = t_max; b_buf(3) = t_min;
+    s_buf(0) = bits - 1;
+    s_buf(1) = bits - 1;
+
+    Var x;
+    Expr a = a_buf(x), b = b_buf(x), s = s_buf(x);
+    int vec = get_jit_target_from_environment().natural_vector_size<T>();
+
+    auto A = [&](int i) { return (int64_t)a_buf(i); };
+    auto B = [&](int i) { return (int64_t)b_buf(i); };
+
+    bool ok = true;
+
+    ok &= check<W>("widening_add", type_name, widening_add(a, b), x, n, vec,
+                   [&](int i) { return (W)((W)a_buf(i) + (W)b_buf(i)); });
+    ok &= check<W>("widening_mul", type_name, widening_mul(a, b), x, n, vec,
+                   [&](int i) { return (W)((W)a_buf(i) * (W)b_buf(i)); });
+    ok &= check<T>("saturating_add", type_name, saturating_add(a, b), x, n, vec,
+                   [&](int i) { return saturate<T>(A(i) + B(i)); });
+    ok &= check<T>("saturating_sub", type_name, saturating_sub(a, b), x, n, vec,
+                   [&](int i) { return saturate<T>(A(i) - B(i)); });
+    ok &= check<T>("saturating_add of a constant", type_name, saturating_add(a, 7), x, n, vec,
+                   [&](int i) { return saturate<T>(A(i) + 7); });
+    ok &= check<T>("halving_add", type_name, halving_add(a, b), x, n, vec,
+                   [&](int i) { return (T)((A(i) + B(i)) >> 1); });
+    ok &= check<T>("rounding_halving_add", type_name, rounding_halving_add(a, b), x, n, vec,
+                   [&](int i) { return (T)((A(i) + B(i) + 1) >> 1); });
+
+    int shifts[] = {0, 1, bits / 2, bits - 1};
+    for (int shift : shifts) {
+        ok &= check<T>("rounding_shift_right", type_name, rounding_shift_right(a, shift), x, n, vec,
+                       [&](int i) { return (T)round_shift_right(A(i), shift); });
+    }
+    ok &= check<T>("rounding_shift_right by a variable", type_name, rounding_shift_right(a, s), x, n, vec,
+                   [&](int i) { return (T)round_shift_right(A(i), s_buf(i)); });
+
+    int q_values[] = {0, bits / 2, bits - 1, bits, 2 * bits - 1};
+    for (int q : q_values) {
+        ok &= check<T>("rounding_mul_shift_right", type_name, rounding_mul_shift_right(a, b, q), x, n, vec,
+                       [&](int i) {
+                           W product = (W)a_buf(i) * (W)b_buf(i);
+                           return saturate<T>(round_shift_right(product, q));
+                       });
+    }
+    ok &= check<T>("rounding_mul_shift_right by a variable", type_name, rounding_mul_shift_right(a, b, s), x, n, vec,
+                   [&](int i) {
+                       W product = (W)a_buf(i) * (W)b_buf(i);
+                       return saturate<T>(round_shift_right(product, s_buf(i)));
+                   });
+
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    bool ok = true;
+    ok &= test<int8_t>("int8");
+    ok &= test<uint8_t>("uint8");
+    ok &= test<int16_t>("int16");
+    ok &= test<uint16_t>("uint16");
+    ok &= test<int32_t>("int32");
+    ok &= test<uint32_t>("uint32");
+
+    if (!ok) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature()) {
+        printf("Not running float16 vector math test on gpu targets\n");
+        return 0;
+    }
+
+    const int size = 1024;
+    std::mt19937 rng(0);
+
+    Buffer<float> in(size);
+    for (int i = 0; i < size; i++) {
+        in(i) = ((int)(rng() % 20000) - 10000) / 7.0f;
+    }
+    // NaN, infinity, and two values exactly between two bfloat16s,
+    // which should round to the even one.
+    in(0) = std::numeric_limits<float>::quiet_NaN();
+    in(1) = std::numeric_limits<float>::infinity();
+    in(2) = 1.0f + 1.0f / 256;
+    in(3) = 1.0f + 3.0f / 256;
+
+    Buffer<bfloat16_t> a_bf(size), b_bf(size);
+    Buffer<float16_t> a_h(size), b_h(size);
+    for (int i = 0; i < size; i++) {
+        a_bf(i) = bfloat16_t(((int)(rng() % 2000) - 1000) / 3.0f);
+        b_bf(i) = bfloat16_t(((int)(rng() % 2000) - 1000) / 3.0f);
+        // Random finite half-precision values of moderate magnitude.
+        uint16_t sign = (rng() % 2) << 15;
+        uint16_t exponent = (10 + rng() % 10) << 10;
+        uint16_t mantissa = rng() % 1024;
+        a_h(i) = float16_t::make_from_bits(sign | exponent | mantissa);
+        mantissa = rng() % 1024;
+        exponent = (10 + rng() % 10) << 10;
+        b_h(i) = float16_t::make_from_bits(exponent | mantissa);
+    }
+
+    Var x;
+
+    {
+        // Rounding float to bfloat16.
+        Func f;
+        f(x) = cast(BFloat(16), in(x));
+        f.vectorize(x, 8);
+        Buffer<bfloat16_t> out = f.realize(size);
+        for (int i = 0; i < size; i++) {
+            bfloat16_t correct(in(i));
+            bool ok = (out(i).to_bits() == correct.to_bits() ||
+                       (out(i).is_nan() && correct.is_nan()));
+            if (!ok) {
+                printf("cast(BFloat(16), %f) = 0x%x instead of 0x%x\n",
+                       in(i), out(i).to_bits(), correct.to_bits());
+                return -1;
+            }
+        }
+        if (!out(0).is_nan() || out(2).to_bits() != 0x3f80 || out(3).to_bits() != 0x3f82) {
+            printf("Special cases of cast(BFloat(16), ...) were incorrect\n");
+            return -1;
+        }
+    }
+
+    {
+        // Arithmetic on bfloat16, which is done in float and rounded
+        // after each operation.
+        Func f, g;
+        f(x) = a_bf(x) * b_bf(x) + a_bf(x);
+        g(x) = select(a_bf(x) < b_bf(x), a_bf(x), b_bf(x));
+        f.vectorize(x, 8);
+        g.vectorize(x, 8);
+        Buffer<bfloat16_t> f_out = f.realize(size);
+        Buffer<bfloat16_t> g_out = g.realize(size);
+        for (int i = 0; i < size; i++) {
+            float a = (float)a_bf(i), b = (float)b_bf(i);
+            bfloat16_t correct_f((float)bfloat16_t(a * b) + a);
+            bfloat16_t correct_g = a < b ? a_bf(i) : b_bf(i);
+            if (f_out(i).to_bits() != correct_f.to_bits()) {
+                printf("%f * %f + %f = %f instead of %f\n",
+                       a, b, a, (float)f_out(i), (float)correct_f);
+                return -1;
+            }
+            if (g_out(i).to_bits() != correct_g.to_bits()) {
+                printf("min(%f, %f) = %f instead of %f\n",
+                       a, b, (float)g_out(i), (float)correct_g);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Arithmetic and math library calls on float16. Compare the
+        // vectorized version to the scalar one, and both to doing the
+        // math in float.
+        Func f, f_scalar, s;
+        f(x) = a_h(x) * b_h(x) + a_h(x);
+        f_scalar(x) = a_h(x) * b_h(x) + a_h(x);
+        s(x) = sin(a_h(x));
+        f.vectorize(x, 16);
+        s.vectorize(x, 16);
+        Buffer<float16_t> f_out = f.realize(size);
+        Buffer<float16_t> f_scalar_out = f_scalar.realize(size);
+        Buffer<float16_t> s_out = s.realize(size);
+        for (int i = 0; i < size; i++) {
+            float a = (float)a_h(i), b = (float)b_h(i);
+            float correct_f = a * b + a;
+            float correct_s = std::sin(a);
+            // Two roundings to half precision.
+            float tolerance = (std::abs(a * b) + std::abs(correct_f)) / 1024.0f;
+            if (f_out(i).to_bits() != f_scalar_out(i).to_bits() ||
+                std::abs((float)f_out(i) - correct_f) > tolerance) {
+                printf("%f * %f + %f = %f (%f when not vectorized) instead of %f\n",
+                       a, b, a, (float)f_out(i), (float)f_scalar_out(i), correct_f);
+                return -1;
+            }
+            if (std::abs((float)s_out(i) - correct_s) > 1.0f / 1024) {
+                printf("sin(%f) = %f instead of %f\n", a, (float)s_out(i), correct_s);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -1,6 +1,11 @@
 // Don't include Halide.h: it is not necessary for this test.
 #include "HalideBuffer.h"
 
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
 using namespace Halide::Runtime;
 
 template<typename T1, typename T2>
@@ -68,6 +73,72 @@ int main(int argc, char **argv) {
         check_equal(a_window, b_window);
     }
 
+    {
+        // Check copying between buffers that are dense in different
+        // dimensions, and between types of every size.
+        Buffer<uint8_t> a8(67, 45), b8(45, 67);
+        Buffer<uint16_t> a16(67, 45), b16(45, 67);
+        Buffer<uint64_t> a64(67, 45), b64(45, 67);
+        b8.fill([&](int x, int y) {return (uint8_t)(x + 3 * y);});
+        b16.fill([&](int x, int y) {return (uint16_t)(x + 300 * y);});
+        b64.fill([&](int x, int y) {return (uint64_t)(x + 300 * y) << 33;});
+        b8.transpose(0, 1);
+        b16.transpose(0, 1);
+        b64.transpose(0, 1);
+        a8.copy_from(b8);
+        a16.copy_from(b16);
+        a64.copy_from(b64);
+        check_equal(a8, b8);
+        check_equal(a16, b16);
+        check_equal(a64, b64);
+
+        // And from a transposed crop into the middle of a larger
+        // buffer.
+        Buffer<uint16_t> c(100, 80);
+        Buffer<const uint16_t> b16_window = b16.cropped(0, 10, 30).cropped(1, 5, 20);
+        c.fill(7);
+        c.copy_from(b16_window);
+        c.for_each_element([&](int x, int y) {
+            bool inside = x >= 10 && x < 40 && y >= 5 && y < 25;
+            uint16_t correct = inside ? b16(x, y) : 7;
+            if (c(x, y) != correct) {
+                printf("c(%d, %d) = %d instead of %d\n", x, y, c(x, y), correct);
+                abort();
+            }
+        });
+
+        // Dimensions of extent one shouldn't get in the way.
+        Buffer<float> d(100, 1, 80), e(30, 1, 20);
+        e.fill([&](int x, int y, int z) {return x + 100.0f * z;});
+        e.set_min(10, 0, 5);
+        d.fill(1.0f);
+        d.copy_from(e);
+        check_equal(d.cropped(0, 10, 30).cropped(2, 5, 20), e);
+    }
+
+    {
+        // Check filling a crop with values that can and can't be
+        // memset.
+        Buffer<int> a(40, 30, 3);
+        a.fill(17);
+        Buffer<int> a_window = a.cropped(0, 5, 10).cropped(1, 5, 10);
+        a_window.fill(0);
+        a.for_each_element([&](int x, int y, int c) {
+            int correct = (x >= 5 && x < 15 && y >= 5 && y < 15) ? 0 : 17;
+            if (a(x, y, c) != correct) {
+                printf("a(%d, %d, %d) = %d instead of %d\n", x, y, c, a(x, y, c), correct);
+                abort();
+            }
+        });
+        a.fill(-1);
+        a.for_each_value([&](int v) {
+            if (v != -1) {
+                printf("Filling with -1 failed\n");
+                abort();
+            }
+        });
+    }
+
     {
         // Check make a Buffer from a Buffer of a different type
         Buffer<float, 2> a(100, 80);
@@ -128,6 +199,64 @@ int main(int argc, char **argv) {
         });
     }
 
+    {
+        // Check the parallel variants of for_each_element and
+        // for_each_value, using a thread per task.
+        int tasks_run = 0;
+        auto executor = [&](int num_tasks, std::function<void(int)> task) {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < num_tasks; i++) {
+                threads.emplace_back(task, i);
+            }
+            for (auto &t : threads) {
+                t.join();
+            }
+            tasks_run += num_tasks;
+        };
+
+        const int W = 37, H = 19, C = 3;
+        Buffer<int> a(W, H, C);
+        a.fill([&](int x, int y, int c) {return x + 100 * y + 10000 * c;});
+        const Buffer<int> &a_const = a;
+        std::atomic<int> count(0);
+        a.for_each_element_parallel(executor, W * 4, [&](int x, int y, int c) {
+            if (a_const(x, y, c) == x + 100 * y + 10000 * c) {
+                count++;
+            }
+        });
+        if (count != W * H * C || tasks_run < 2) {
+            printf("for_each_element_parallel visited %d sites in %d tasks\n", (int)count, tasks_run);
+            return -1;
+        }
+
+        // A callable that doesn't iterate over the last dimension
+        // should still see each site once.
+        count = 0;
+        a.for_each_element_parallel(executor, 1, [&](int x, int y) {
+            count++;
+        });
+        if (count != W * H) {
+            printf("for_each_element_parallel visited %d sites instead of %d\n", (int)count, W * H);
+            return -1;
+        }
+
+        Buffer<int> b = Buffer<int>::make_interleaved(W, H, C);
+        tasks_run = 0;
+        b.for_each_value_parallel(executor, W * C, [&](int &b, int a) {
+            b = 2 * a;
+        }, a);
+        if (tasks_run != H) {
+            printf("for_each_value_parallel ran %d tasks instead of %d\n", tasks_run, H);
+            return -1;
+        }
+        b.for_each_element([&](int x, int y, int c) {
+            if (b(x, y, c) != 2 * a(x, y, c)) {
+                printf("b(%d, %d, %d) = %d instead of %d\n", x, y, c, b(x, y, c), 2 * a(x, y, c));
+                abort();
+            }
+        });
+    }
+
     printf("Success!\n");
     return 0;
 }
@@ -42,6 +42,81 @@ void test_round_trip(Buffer<uint8_t> buf, std::string format) {
     }
 }
 
+void test_load_into(Buffer<uint8_t> buf, std::string format) {
+    std::string filename = Internal::get_test_tmp_dir() + "test_into." + format;
+    Tools::save_image(buf, filename);
+    Buffer<uint8_t> reloaded = Tools::load_image(filename);
+
+    // Decode a crop of the file straight into a planar float buffer
+    // and an interleaved uint16 one.
+    Buffer<float> planar(100, 50, 3);
+    planar.set_min(123, 456, 0);
+    if (!Tools::load_into(filename, &planar)) {
+        printf("load_into of a planar crop of %s failed\n", filename.c_str());
+        abort();
+    }
+    Buffer<uint16_t> interleaved = Buffer<uint16_t>::make_interleaved(100, 50, 2);
+    interleaved.set_min(17, 1100, 1);
+    if (!Tools::load_into(filename, &interleaved)) {
+        printf("load_into of an interleaved crop of %s failed\n", filename.c_str());
+        abort();
+    }
+    planar.for_each_element([&](int x, int y, int c) {
+        float correct = reloaded(x, y, c) / 255.0f;
+        if (planar(x, y, c) != correct) {
+            printf("planar(%d, %d, %d) = %f instead of %f\n", x, y, c, planar(x, y, c), correct);
+            abort();
+        }
+    });
+    interleaved.for_each_element([&](int x, int y, int c) {
+        uint16_t correct = reloaded(x, y, c) << 8;
+        if (interleaved(x, y, c) != correct) {
+            printf("interleaved(%d, %d, %d) = %d instead of %d\n", x, y, c, interleaved(x, y, c), correct);
+            abort();
+        }
+    });
+
+    // Regions outside the file are an error.
+    Buffer<uint8_t> too_big(buf.width() + 1, 10, 3);
+    if (Tools::load_into(filename, &too_big)) {
+        printf("load_into of a region outside %s should have failed\n", filename.c_str());
+        abort();
+    }
+}
+
+void test_load_and_save_all(Buffer<uint8_t> buf) {
+    // Save an image as several files at once, in both formats, and
+    // load them all back.
+    std::vector<Buffer<uint8_t>> images;
+    std::vector<std::string> filenames;
+    for (int i = 0; i < 8; i++) {
+        Buffer<uint8_t> im(buf.width(), buf.height(), buf.channels());
+        im.for_each_element([&](int x, int y, int c) {
+            im(x, y, c) = buf(x, y, c) + i;
+        });
+        images.push_back(im);
+        filenames.push_back(Internal::get_test_tmp_dir() + "test_all_" + std::to_string(i) +
+                            ((i & 1) ? ".png" : ".ppm"));
+    }
+    if (!Tools::save_all(images, filenames, 4)) {
+        printf("save_all failed\n");
+        abort();
+    }
+    std::vector<Buffer<uint8_t>> reloaded;
+    if (!Tools::load_all(filenames, &reloaded, 4)) {
+        printf("load_all failed\n");
+        abort();
+    }
+    for (int i = 0; i < 8; i++) {
+        images[i].for_each_element([&](int x, int y, int c) {
+            if (images[i](x, y, c) != reloaded[i](x, y, c)) {
+                printf("Image %d differs after save_all and load_all at (%d, %d, %d)\n", i, x, y, c);
+                abort();
+            }
+        });
+    }
+}
+
 Func make_noise(int depth) {
     Func f;
     Var x, y, c;
@@ -83,6 +158,12 @@ int main(int argc, char **argv) {
             test_round_trip(luma_buf, format);
         }
     }
+
+    test_load_into(color_buf, "png");
+    test_load_into(color_buf, "jpg");
+    test_load_and_save_all(color_buf);
+
+    printf("Success!\n");
     return 0;
 }
 
@@ -0,0 +1,150 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <limits>
+#include <random>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the vector divisions and modulos left in the IR. Division by a
+// loop-invariant value should have been replaced with multiplies and
+// shifts.
+class CountVectorDivisions : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Div *op) {
+        if (op->type.is_vector()) {
+            count++;
+        }
+        IRMutator::visit(op);
+    }
+
+    void visit(const Mod *op) {
+        if (op->type.is_vector()) {
+            count++;
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    int count = 0;
+};
+
+// Halide's division rounds according to the sign of the divisor, so
+// that the remainder is always non-negative.
+int64_t euclidean_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    int64_t r = a - q * b;
+    if (r < 0) {
+        q += (b > 0) ? -1 : 1;
+    }
+    return q;
+}
+
+template<typename T>
+bool test(const char *type_name) {
+    const int n = 256;
+    const bool is_signed = std::numeric_limits<T>::is_signed;
+    const T t_min = std::numeric_limits<T>::min();
+    const T t_max = std::numeric_limits<T>::max();
+
+    Buffer<T> input(n);
+    std::mt19937 rng(sizeof(T));
+    for (int i = 0; i < n; i++) {
+        input(i) = (T)rng();
+    }
+    input(0) = t_min;
+    input(1) = t_max;
+    input(2) = 0;
+
+    std::vector<T> divisors = {1, 2, 3, 7, 10, 100, (T)(t_max / 2), (T)(t_max / 2 + 1), t_max};
+    if (is_signed) {
+        std::vector<T> negative = {(T)-2, (T)-3, (T)-7, (T)-100, t_min, (T)(t_min + 1)};
+        divisors.insert(divisors.end(), negative.begin(), negative.end());
+    }
+    for (int i = 0; i < 20; i++) {
+        T d = (T)rng();
+        if (d != 0) {
+            divisors.push_back(d);
+        }
+    }
+
+    Param<T> p;
+    Var x;
+    Func f;
+    f(x) = Tuple(input(x) / p, input(x) % p);
+    f.vectorize(x, get_jit_target_from_environment().natural_vector_size<T>());
+
+    CountVectorDivisions *counter = new CountVectorDivisions;
+    f.add_custom_lowering_pass(counter);
+    f.compile_jit();
+    if (counter->count != 0) {
+        printf("There were %d vector divisions or modulos left for %s\n", counter->count, type_name);
+        return false;
+    }
+
+    for (T d : divisors) {
+        p.set(d);
+        Realization r = f.realize(n);
+        Buffer<T> quotient = r[0], remainder = r[1];
+        for (int i = 0; i < n; i++) {
+            int64_t a = input(i);
+            if (is_signed && a == t_min && d == (T)-1) {
+                // Overflows
+                continue;
+            }
+            T correct_q = (T)euclidean_div(a, d);
+            T correct_r = (T)(a - euclidean_div(a, d) * (int64_t)d);
+            if (quotient(i) != correct_q || remainder(i) != correct_r) {
+                printf("%s: %lld / %lld = %lld, %lld %% %lld = %lld instead of %lld and %lld\n",
+                       type_name, (long long)a, (long long)d, (long long)quotient(i),
+                       (long long)a, (long long)d, (long long)remainder(i),
+                       (long long)correct_q, (long long)correct_r);
+                return false;
+            }
+        }
+    }
+
+    // A divisor that varies with an outer loop.
+    Func g;
+    Var y;
+    Expr divisor = cast<T>(y + 3);
+    g(x, y) = input(x) / divisor;
+    g.vectorize(x, get_jit_target_from_environment().natural_vector_size<T>());
+    Buffer<T> out = g.realize(n, 50);
+    for (int y = 0; y < out.height(); y++) {
+        for (int i = 0; i < n; i++) {
+            T correct = (T)euclidean_div(input(i), (T)(y + 3));
+            if (out(i, y) != correct) {
+                printf("%s: %lld / %d = %lld instead of %lld\n",
+                       type_name, (long long)input(i), y + 3,
+                       (long long)out(i, y), (long long)correct);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (get_jit_target_from_environment().has_gpu_feature()) {
+        printf("Not running invariant division test on gpu targets\n");
+        return 0;
+    }
+
+    bool ok = true;
+    ok &= test<int8_t>("int8");
+    ok &= test<uint8_t>("uint8");
+    ok &= test<int16_t>("int16");
+    ok &= test<uint16_t>("uint16");
+    ok &= test<int32_t>("int32");
+    ok &= test<uint32_t>("uint32");
+
+    if (!ok) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+
+using namespace Halide;
+
+// Track the heap memory in use, to check the footprint is an upper
+// bound on it.
+std::atomic<uint64_t> heap_in_use(0), peak_heap(0);
+
+void *my_malloc(void *user_context, size_t x) {
+    void *orig = malloc(x + 64);
+    void *ptr = (void *)((((size_t)orig + 64) >> 5) << 5);
+    ((void **)ptr)[-1] = orig;
+    ((size_t *)ptr)[-2] = x;
+    uint64_t current = (heap_in_use += x);
+    uint64_t prev = peak_heap;
+    while (current > prev && !peak_heap.compare_exchange_weak(prev, current)) {
+    }
+    return ptr;
+}
+
+void my_free(void *user_context, void *ptr) {
+    heap_in_use -= ((size_t *)ptr)[-2];
+    free(((void **)ptr)[-1]);
+}
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature()) {
+        printf("Not running memory_footprint test on gpu targets\n");
+        return 0;
+    }
+
+    const int W = 200, H = 100;
+    Var x, y, xo, yo, xi, yi;
+
+    {
+        // A root intermediate whose size depends on a Param.
+        Param<int> scale;
+        Func f, g;
+        f(x, y) = x + y;
+        g(x, y) = f(x * scale, y) + f(x * scale + 1, y);
+        f.compute_root();
+        g.set_custom_allocator(my_malloc, my_free);
+
+        for (int s = 1; s <= 4; s++) {
+            scale.set(s);
+
+            // The output doesn't need to be allocated to query the
+            // footprint.
+            Buffer<int> shape((int *)nullptr, W, H);
+            MemoryFootprint footprint = g.memory_footprint(shape);
+
+            uint64_t f_size = (uint64_t)((W - 1) * s + 2) * H * sizeof(int);
+            if (footprint.heap_bytes < f_size || footprint.heap_bytes > f_size + 1024) {
+                printf("Heap footprint with scale %d is %llu instead of about %llu\n",
+                       s, (unsigned long long)footprint.heap_bytes, (unsigned long long)f_size);
+                return -1;
+            }
+
+            peak_heap = 0;
+            Buffer<int> out = g.realize(W, H);
+            if (peak_heap > footprint.heap_bytes) {
+                printf("Pipeline used %llu bytes of heap, but the footprint was %llu\n",
+                       (unsigned long long)peak_heap, (unsigned long long)footprint.heap_bytes);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Every iteration of a parallel loop may be running at
+        // once, so a per-row allocation counts once per row.
+        Func f, g;
+        f(x, y) = x * y;
+        g(x, y) = f(x - 1, y) + f(x + 1, y);
+        f.compute_at(g, y);
+        g.parallel(y);
+        g.set_custom_allocator(my_malloc, my_free);
+
+        Buffer<int> out(W, H);
+        MemoryFootprint footprint = g.memory_footprint(out);
+        uint64_t row_size = (W + 2) * sizeof(int);
+        if (footprint.heap_bytes < row_size * H) {
+            printf("Heap footprint of parallel loop is %llu, less than %llu\n",
+                   (unsigned long long)footprint.heap_bytes, (unsigned long long)(row_size * H));
+            return -1;
+        }
+
+        peak_heap = 0;
+        g.realize(out);
+        if (peak_heap > footprint.heap_bytes) {
+            printf("Pipeline used %llu bytes of heap, but the footprint was %llu\n",
+                   (unsigned long long)peak_heap, (unsigned long long)footprint.heap_bytes);
+            return -1;
+        }
+    }
+
+    {
+        // Small constant-sized allocations go on the stack.
+        Func f, g;
+        f(x, y) = x + y;
+        g(x, y) = f(x, y) * 2;
+        g.tile(x, y, xo, yo, xi, yi, 8, 8);
+        f.compute_at(g, xo);
+
+        Buffer<int> out(W, H);
+        MemoryFootprint footprint = g.memory_footprint(out);
+        if (footprint.heap_bytes != 0) {
+            printf("Heap footprint is %llu instead of 0\n",
+                   (unsigned long long)footprint.heap_bytes);
+            return -1;
+        }
+        if (footprint.stack_bytes < 8 * 8 * sizeof(int)) {
+            printf("Stack footprint is %llu, less than %d\n",
+                   (unsigned long long)footprint.stack_bytes, (int)(8 * 8 * sizeof(int)));
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <atomic>
+#include <stdio.h>
+#include "Halide.h"
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+std::atomic<int> count;
+extern "C" DLLEXPORT int call_counter(int x, int y) {
+    count++;
+    return x + y;
+}
+HalideExtern_2(int, call_counter, int, int);
+
+// Record the largest heap allocation made.
+std::atomic<size_t> largest_allocation;
+void *my_malloc(void *user_context, size_t x) {
+    size_t prev = largest_allocation;
+    while (x > prev && !largest_allocation.compare_exchange_weak(prev, x)) {
+    }
+    void *orig = malloc(x + 32);
+    void *ptr = (void *)((((size_t)orig + 32) >> 5) << 5);
+    ((void **)ptr)[-1] = orig;
+    return ptr;
+}
+
+void my_free(void *user_context, void *ptr) {
+    free(((void **)ptr)[-1]);
+}
+
+int main(int argc, char **argv) {
+    Var x, y;
+
+    {
+        count = 0;
+        Func f, g;
+
+        f(x, y) = call_counter(x, y);
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        // Each strip of 16 scanlines of g should compute its two rows
+        // of overlap once, and then slide along y.
+        g.parallel_strips(y, 16);
+        f.store_root().compute_at(g, y);
+        g.set_custom_allocator(my_malloc, my_free);
+
+        largest_allocation = 0;
+        Buffer<int> im = g.realize(10, 64);
+
+        // Each strip's buffer for f should cover at most the strip
+        // plus its overlap, not the whole image.
+        size_t strip_footprint = (16 + 2) * 10 * sizeof(int) + 64;
+        if (largest_allocation > strip_footprint) {
+            printf("Allocated %d bytes for f, more than a strip's footprint of %d\n",
+                   (int)largest_allocation, (int)strip_footprint);
+            return -1;
+        }
+
+        int correct_count = 4 * (16 + 2) * 10;
+        if (count != correct_count) {
+            printf("f was called %d times instead of %d times\n", (int)count, correct_count);
+            return -1;
+        }
+
+        for (int y = 0; y < im.height(); y++) {
+            for (int x = 0; x < im.width(); x++) {
+                int correct = 3 * (x + y);
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        count = 0;
+        Func f, g, h;
+
+        // A chain of two stencils, with a strip size that doesn't
+        // divide the output.
+        f(x, y) = call_counter(x, y);
+        g(x, y) = f(x, y - 1) + f(x, y + 1);
+        h(x, y) = g(x, y - 1) + g(x, y + 1);
+
+        h.parallel_strips(y, 10);
+        g.store_root().compute_at(h, y);
+        f.store_root().compute_at(h, y);
+
+        Buffer<int> im = h.realize(10, 64);
+
+        for (int y = 0; y < im.height(); y++) {
+            for (int x = 0; x < im.width(); x++) {
+                int correct = 4 * (x + y);
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+
+        // Without strips each scanline of h would compute six
+        // scanlines of f. With sliding within each strip, it should
+        // be much closer to one.
+        if (count > 2 * 10 * 64) {
+            printf("f was called %d times, which is too many\n", (int)count);
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
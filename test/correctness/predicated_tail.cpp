@@ -0,0 +1,91 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the scalar stores to a buffer, which is what the tail of a
+// vectorized loop turns into if it can't be predicated.
+class CountScalarStores : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Store *op) {
+        if (op->name == name && op->value.type().is_scalar()) {
+            count++;
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    std::string name;
+    int count = 0;
+    CountScalarStores(const std::string &n) : name(n) {}
+};
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature()) {
+        printf("Not running predicated tail test on gpu targets\n");
+        return 0;
+    }
+
+    Var x, y;
+
+    {
+        // An output whose width isn't a multiple of the vector size.
+        Buffer<int> input(37, 10);
+        input.for_each_element([&](int x, int y) { input(x, y) = x * 3 + y; });
+
+        Func f("f");
+        f(x, y) = input(x, y) * 2 + 1;
+        f.vectorize(x, 8, TailStrategy::Predicate);
+
+        CountScalarStores *counter = new CountScalarStores(f.name());
+        f.add_custom_lowering_pass(counter, nullptr);
+
+        Buffer<int> out = f.realize(37, 10);
+        for (int y = 0; y < out.height(); y++) {
+            for (int x = 0; x < out.width(); x++) {
+                int correct = (x * 3 + y) * 2 + 1;
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+
+        if (counter->count != 0) {
+            printf("There were %d scalar stores to %s. The tail should have been predicated.\n",
+                   counter->count, f.name().c_str());
+            return -1;
+        }
+        delete counter;
+    }
+
+    {
+        // A narrow type, with the inner loop split again after the
+        // predicated split, and an update stage.
+        Buffer<uint8_t> input(50);
+        input.for_each_element([&](int x) { input(x) = x * 7; });
+
+        Func g("g");
+        Var xo, xi, xii;
+        g(x) = input(x);
+        g(x) += cast<uint8_t>(x);
+        g.split(x, xo, xi, 32, TailStrategy::Predicate);
+        g.update().split(x, xo, xi, 32, TailStrategy::Predicate)
+            .split(xi, xi, xii, 16).vectorize(xii);
+
+        Buffer<uint8_t> out = g.realize(50);
+        for (int x = 0; x < out.width(); x++) {
+            uint8_t correct = (uint8_t)(x * 7 + x);
+            if (out(x) != correct) {
+                printf("out(%d) = %d instead of %d\n", x, out(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int N = 37;
+
+    ImageParam input(UInt(8), 2, "input");
+    ImageParam weights(Float(32), 1, "weights");
+    Param<float> offset;
+    Var x, y;
+    Func f, g;
+    f(x, y) = input(x, y) * weights(x % 4) + offset;
+    g(x, y) = cast<uint8_t>(input(y, x) / 2);
+    f.vectorize(x, 8).parallel(y);
+    Pipeline p({f, g});
+
+    // The weights and offset are shared by every item. The input and
+    // the outputs differ per item.
+    Buffer<float> w(4);
+    for (int i = 0; i < 4; i++) {
+        w(i) = i * 0.5f;
+    }
+    weights.set(w);
+    offset.set(3.0f);
+
+    std::vector<Buffer<>> inputs;
+    std::vector<Realization> outputs;
+    for (int i = 0; i < N; i++) {
+        Buffer<uint8_t> in(64, 64);
+        in.for_each_element([&](int x, int y) {in(x, y) = (uint8_t)(x + y * 3 + i);});
+        inputs.push_back(in);
+        Buffer<float> f_out(64, 64);
+        Buffer<uint8_t> g_out(64, 64);
+        outputs.push_back(Realization({f_out, g_out}));
+    }
+
+    p.realize_batch(outputs, {{input.name(), inputs}});
+
+    for (int i = 0; i < N; i++) {
+        Buffer<uint8_t> in = inputs[i];
+        Buffer<float> f_out = outputs[i][0];
+        Buffer<uint8_t> g_out = outputs[i][1];
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 64; x++) {
+                float correct_f = in(x, y) * w(x % 4) + 3.0f;
+                uint8_t correct_g = in(y, x) / 2;
+                if (f_out(x, y) != correct_f) {
+                    printf("Item %d: f(%d, %d) = %f instead of %f\n", i, x, y, f_out(x, y), correct_f);
+                    return -1;
+                }
+                if (g_out(x, y) != correct_g) {
+                    printf("Item %d: g(%d, %d) = %d instead of %d\n", i, x, y, g_out(x, y), correct_g);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // An empty batch does nothing.
+    p.realize_batch({});
+
+    printf("Success!\n");
+    return 0;
+}
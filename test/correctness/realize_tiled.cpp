@@ -0,0 +1,144 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <atomic>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature()) {
+        printf("Not running realize_tiled test on gpu targets\n");
+        return 0;
+    }
+
+    const int W = 1000, H = 700;
+
+    ImageParam input(Int(32), 2, "input");
+    Var x, y;
+    Func blur_x, blur_y, sum;
+    blur_x(x, y) = input(x - 1, y) + input(x, y) + input(x + 1, y);
+    blur_y(x, y) = blur_x(x, y - 1) + blur_x(x, y) + blur_x(x, y + 1);
+    sum(x, y) = blur_x(x, y) * 2;
+    blur_x.compute_root();
+    blur_y.vectorize(x, 8).parallel(y);
+    sum.vectorize(x, 8);
+    Pipeline p({blur_y, sum});
+
+    auto input_value = [](int x, int y) {return x * 3 + y * 1001;};
+    auto correct_blur_y = [&](int x, int y) {
+        int result = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                result += input_value(x + dx, y + dy);
+            }
+        }
+        return result;
+    };
+    auto correct_sum = [&](int x, int y) {
+        return (input_value(x - 1, y) + input_value(x, y) + input_value(x + 1, y)) * 2;
+    };
+
+    auto check = [&](Buffer<int> out_blur, Buffer<int> out_sum) {
+        for (int y = out_blur.dim(1).min(); y <= out_blur.dim(1).max(); y++) {
+            for (int x = out_blur.dim(0).min(); x <= out_blur.dim(0).max(); x++) {
+                if (out_blur(x, y) != correct_blur_y(x, y)) {
+                    printf("blur_y(%d, %d) = %d instead of %d\n",
+                           x, y, out_blur(x, y), correct_blur_y(x, y));
+                    return false;
+                }
+                if (out_sum(x, y) != correct_sum(x, y)) {
+                    printf("sum(%d, %d) = %d instead of %d\n",
+                           x, y, out_sum(x, y), correct_sum(x, y));
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    {
+        // Fill in the input one window at a time. The output doesn't
+        // start at the origin, and its size isn't a multiple of the
+        // tile size.
+        Buffer<int> out_blur(W, H), out_sum(W, H);
+        out_blur.set_min(-3, 5);
+        out_sum.set_min(-3, 5);
+
+        std::atomic<int> calls(0);
+        std::atomic<size_t> largest_window(0);
+        p.realize_tiled({out_blur, out_sum}, {128, 64},
+                        [&](const std::string &name, Buffer<> window) {
+            if (name != input.name()) {
+                printf("Callback called for %s instead of %s\n", name.c_str(), input.name().c_str());
+                abort();
+            }
+            Buffer<int> w(window);
+            for (int y = w.dim(1).min(); y <= w.dim(1).max(); y++) {
+                for (int x = w.dim(0).min(); x <= w.dim(0).max(); x++) {
+                    w(x, y) = input_value(x, y);
+                }
+            }
+            size_t size = (size_t)w.width() * w.height();
+            size_t prev = largest_window;
+            while (size > prev && !largest_window.compare_exchange_weak(prev, size)) {
+            }
+            calls++;
+        });
+
+        if (!check(out_blur, out_sum)) {
+            return -1;
+        }
+
+        // 1000 = 7 * 128 + 104 and 700 = 10 * 64 + 60, so there
+        // should be 8 x 11 tiles.
+        if (calls != 8 * 11) {
+            printf("Input callback was called %d times instead of %d\n", (int)calls, 8 * 11);
+            return -1;
+        }
+
+        // The windows should be the size of a tile plus the stencil.
+        if (largest_window > (size_t)(128 + 2) * (64 + 2)) {
+            printf("Largest input window was %d elements\n", (int)largest_window);
+            return -1;
+        }
+    }
+
+    {
+        // A leftover strip narrower than half a tile is merged into
+        // the last tile, so there's no tile narrower than the vector
+        // width.
+        Buffer<int> out_blur(1027, 50), out_sum(1027, 50);
+        std::atomic<int> calls(0);
+        p.realize_tiled({out_blur, out_sum}, {128},
+                        [&](const std::string &name, Buffer<> window) {
+            Buffer<int> w(window);
+            w.for_each_element([&](int x, int y) {w(x, y) = input_value(x, y);});
+            calls++;
+        }, 3);
+        if (!check(out_blur, out_sum)) {
+            return -1;
+        }
+        if (calls != 8) {
+            printf("Input callback was called %d times instead of 8\n", (int)calls);
+            return -1;
+        }
+    }
+
+    {
+        // With the input bound to a buffer, it's passed to each tile
+        // as is.
+        Buffer<int> in(W + 2, H + 2);
+        in.set_min(-1, -1);
+        in.for_each_element([&](int x, int y) {in(x, y) = input_value(x, y);});
+        input.set(in);
+
+        Buffer<int> out_blur(W, H), out_sum(W, H);
+        p.realize_tiled({out_blur, out_sum}, {256, 256});
+        if (!check(out_blur, out_sum)) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
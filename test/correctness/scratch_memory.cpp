@@ -0,0 +1,83 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature()) {
+        printf("Not running scratch_memory test on gpu targets\n");
+        return 0;
+    }
+
+    Var x, y;
+    Func f, g, h;
+    f(x, y) = x + y;
+    g(x, y) = f(x - 1, y) + f(x + 1, y);
+    h(x, y) = g(x, y - 1) + g(x, y + 1);
+    f.compute_root();
+    g.compute_root();
+
+    Runtime::ScratchMemory scratch;
+    h.set_scratch_memory(&scratch);
+
+    Buffer<int> out = h.realize(200, 100);
+    uint64_t allocations = scratch.num_system_allocations();
+    if (allocations == 0) {
+        printf("Pipeline didn't allocate from the ScratchMemory\n");
+        return -1;
+    }
+    size_t held = scratch.size_in_bytes();
+
+    // Later calls of the same size or smaller should reuse the blocks.
+    for (int i = 0; i < 10; i++) {
+        out = h.realize(200 - i, 100 - i);
+        out.for_each_element([&](int x, int y) {
+            int correct = 4 * (x + y);
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                abort();
+            }
+        });
+    }
+    if (scratch.num_system_allocations() != allocations) {
+        printf("Repeated calls made %d system allocations\n",
+               (int)(scratch.num_system_allocations() - allocations));
+        return -1;
+    }
+    if (scratch.size_in_bytes() != held) {
+        printf("Memory held grew from %d to %d bytes\n",
+               (int)held, (int)scratch.size_in_bytes());
+        return -1;
+    }
+
+    // A larger call replaces the blocks that are too small rather
+    // than adding to them.
+    out = h.realize(400, 200);
+    if (scratch.size_in_bytes() > 4 * held + 1024) {
+        printf("Memory held grew to %d bytes\n", (int)scratch.size_in_bytes());
+        return -1;
+    }
+
+    // Memory reserved up front is used by the first call.
+    Runtime::ScratchMemory reserved;
+    reserved.reserve(1024 * 1024, 2);
+    h.set_scratch_memory(&reserved);
+    out = h.realize(200, 100);
+    if (reserved.num_system_allocations() != 2) {
+        printf("Reserved memory wasn't used\n");
+        return -1;
+    }
+
+    // Turning it off again returns to the default allocator.
+    h.set_scratch_memory(nullptr);
+    scratch.clear();
+    out = h.realize(200, 100);
+    if (scratch.size_in_bytes() != 0) {
+        printf("ScratchMemory was used after being unset\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -274,8 +274,10 @@ struct Test {
     void check_sse_all() {
         #if LLVM_VERSION > 39
         #define YMM "*ymm"
+        #define ZMM "*zmm"
         #else
         #define YMM
+        #define ZMM
         #endif
 
         Expr f64_1 = in_f64(x), f64_2 = in_f64(x+16), f64_3 = in_f64(x+32);
@@ -313,6 +315,14 @@ struct Test {
             check("paddusb", 8*w, u8(min(u16(u8_1) + u16(u8_2), max_u8)));
             check("psubusb", 8*w, u8(max(i16(u8_1) - i16(u8_2), 0)));
 
+            // The fixed-point intrinsics should lower to the same instructions.
+            check("paddsb",  8*w, saturating_add(i8_1, i8_2));
+            check("psubsb",  8*w, saturating_sub(i8_1, i8_2));
+            check("paddusb", 8*w, saturating_add(u8_1, u8_2));
+            check("psubusb", 8*w, saturating_sub(u8_1, u8_2));
+            check("paddsw",  4*w, saturating_add(i16_1, i16_2));
+            check("psubusw", 4*w, saturating_sub(u16_1, u16_2));
+
             check("paddsw",  4*w, i16_sat(i32(i16_1) + i32(i16_2)));
             check("psubsw",  4*w, i16_sat(i32(i16_1) - i32(i16_2)));
             check("paddusw", 4*w, u16(min(u32(u16_1) + u32(u16_2), max_u16)));
@@ -363,6 +373,8 @@ struct Test {
             check("pavgb", 8*w, u8((u16(u8_1) + u16(u8_2) + 1)>>1));
             check("pavgw", 4*w, u16((u32(u16_1) + u32(u16_2) + 1)/2));
             check("pavgw", 4*w, u16((u32(u16_1) + u32(u16_2) + 1)>>1));
+            check("pavgb", 8*w, rounding_halving_add(u8_1, u8_2));
+            check("pavgw", 4*w, rounding_halving_add(u16_1, u16_2));
             check("pmaxsw", 4*w, max(i16_1, i16_2));
             check("pminsw", 4*w, min(i16_1, i16_2));
             check("pmaxub", 8*w, max(u8_1, u8_2));
@@ -471,6 +483,7 @@ struct Test {
                     check("pmuludq", 2*w, u64(u32_1) * u64(u32_2));
                 }
                 check("pmulld", 2*w, i32_1 * i32_2);
+                check("pmulhrsw", 4*w, rounding_mul_shift_right(i16_1, i16_2, 15));
 
                 check((use_avx512_skylake && w > 2) ? "vinsertf32x8" : "blend*ps", 2*w, select(f32_1 > 0.7f, f32_1, f32_2));
                 check((use_avx512 && w > 2) ? "vinsertf64x4" : "blend*pd", w, select(f64_1 > cast<double>(0.7f), f64_1, f64_2));
@@ -559,6 +572,11 @@ struct Test {
             // check("vperm", 8, in_f32(100-x));
         }
 
+        if (use_avx && target.has_feature(Target::F16C)) {
+            check("vcvtph2ps", 8, f32(reinterpret(Float(16), u16_1)));
+            check("vcvtps2ph", 8, reinterpret(UInt(16), cast(Float(16), f32_1)));
+        }
+
         // AVX 2
 
         if (use_avx2) {
@@ -589,6 +607,8 @@ struct Test {
 
             check("vpavgb", 32, u8((u16(u8_1) + u16(u8_2) + 1)/2));
             check("vpavgw", 16, u16((u32(u16_1) + u32(u16_2) + 1)/2));
+            check("vpavgb", 32, rounding_halving_add(u8_1, u8_2));
+            check("vpmulhrsw" YMM, 16, rounding_mul_shift_right(i16_1, i16_2, 15));
             check("vpmaxsw" YMM, 16, max(i16_1, i16_2));
             check("vpminsw" YMM, 16, min(i16_1, i16_2));
             check("vpmaxub" YMM, 32, max(u8_1, u8_2));
@@ -630,6 +650,14 @@ struct Test {
             check("vpcmpeqq" YMM, 4, select(i64_1 == i64_2, i64(1), i64(2)));
             check("vpackusdw", 16, u16(clamp(i32_1, 0, max_u16)));
             check("vpcmpgtq" YMM, 4, select(i64_1 > i64_2, i64(1), i64(2)));
+
+            #if LLVM_VERSION >= 40
+            // Lookup tables
+            check("vpgatherdd", 8, in_i32(i32(u8_1)));
+            check("vgatherdps", 8, in_f32(i32(u8_1)));
+            check("vpgatherdq", 4, in_i64(i32(u8_1)));
+            check("vgatherdpd", 4, in_f64(i32(u8_1)));
+            #endif
         }
 
         if (use_avx512) {
@@ -648,7 +676,38 @@ struct Test {
             check("vreducepd", 8, f64_1 - trunc(f64_1*8)/8);
 #endif
         }
+        if (use_avx512) {
+            #if LLVM_VERSION >= 40
+            check("vpgatherdd" ZMM, 16, in_i32(i32(u8_1)));
+            check("vgatherdps" ZMM, 16, in_f32(i32(u8_1)));
+            check("vpgatherdq" ZMM, 8, in_i64(i32(u8_1)));
+            #endif
+        }
         if (use_avx512_skylake) {
+            #if LLVM_VERSION >= 40
+            check("vpaddsb" ZMM, 64, i8_sat(i16(i8_1) + i16(i8_2)));
+            check("vpsubsb" ZMM, 64, i8_sat(i16(i8_1) - i16(i8_2)));
+            check("vpaddusb" ZMM, 64, u8(min(u16(u8_1) + u16(u8_2), max_u8)));
+            check("vpsubusb" ZMM, 64, u8(max(i16(u8_1) - i16(u8_2), 0)));
+            check("vpaddsw" ZMM, 32, i16_sat(i32(i16_1) + i32(i16_2)));
+            check("vpsubsw" ZMM, 32, i16_sat(i32(i16_1) - i32(i16_2)));
+            check("vpaddusw" ZMM, 32, u16(min(u32(u16_1) + u32(u16_2), max_u16)));
+            check("vpsubusw" ZMM, 32, u16(max(i32(u16_1) - i32(u16_2), 0)));
+            check("vpavgb" ZMM, 64, u8((u16(u8_1) + u16(u8_2) + 1)/2));
+            check("vpavgw" ZMM, 32, u16((u32(u16_1) + u32(u16_2) + 1)/2));
+            check("vpmulhw" ZMM, 32, i16((i32(i16_1) * i32(i16_2)) / (256*256)));
+            check("vpmulhuw" ZMM, 32, u16((u32(u16_1) * u32(u16_2)) >> 16));
+            check("vpmaddwd" ZMM, 16, i32(i16_1) * 3 + i32(i16_2) * 4);
+
+            // Comparisons write to mask registers
+            check("vpcmp*b*k", 64, select(u8_1 == u8_2, u8(1), u8(2)));
+            check("vpcmp*b*k", 64, select(u8_1 > u8_2, u8(1), u8(2)));
+            check("vpcmp*w*k", 32, select(u16_1 == u16_2, u16(1), u16(2)));
+            check("vpcmp*w*k", 32, select(u16_1 > u16_2, u16(1), u16(2)));
+            check("vpcmp*d*k", 16, select(u32_1 == u32_2, u32(1), u32(2)));
+            check("vcmp*ps*k", 16, select(f32_1 > f32_2, f32_3, f32_1));
+            #endif
+
             check("vpabsq", 8, abs(i64_1));
             check("vpmaxuq", 8, max(u64_1, u64_2));
             check("vpminuq", 8, min(u64_1, u64_2));
@@ -871,6 +930,8 @@ struct Test {
             check(arm32 ? "vhadd.u16" : "uhadd", 4*w, u16((u32(u16_1) + u32(u16_2))/2));
             check(arm32 ? "vhadd.s32" : "shadd", 2*w, i32((i64(i32_1) + i64(i32_2))/2));
             check(arm32 ? "vhadd.u32" : "uhadd", 2*w, u32((u64(u32_1) + u64(u32_2))/2));
+            check(arm32 ? "vhadd.s8"  : "shadd", 8*w, halving_add(i8_1, i8_2));
+            check(arm32 ? "vhadd.u16" : "uhadd", 4*w, halving_add(u16_1, u16_2));
 
             // Halide doesn't define overflow behavior for i32 so we
             // can use vhadd instruction. We can't use it for unsigned u8,i16,u16,u32.
@@ -1108,6 +1169,11 @@ struct Test {
             check(arm32 ? "vqadd.u8"  : "uqadd", 8*w,  u8(min(u16(u8_1)  + 17,  max_u8)));
             check(arm32 ? "vqadd.u16" : "uqadd", 4*w, u16(min(u32(u16_1) + 17, max_u16)));
 
+            check(arm32 ? "vqadd.s8"  : "sqadd", 8*w, saturating_add(i8_1, i8_2));
+            check(arm32 ? "vqadd.u8"  : "uqadd", 8*w, saturating_add(u8_1, u8_2));
+            check(arm32 ? "vqadd.s16" : "sqadd", 4*w, saturating_add(i16_1, i16_2));
+            check(arm32 ? "vqadd.u16" : "uqadd", 4*w, saturating_add(u16_1, u16_2));
+
             // Can't do larger ones because we only have i32 constants
 
             // VQDMLAL  I       -       Saturating Double Multiply Accumulate Long
@@ -1140,6 +1206,8 @@ struct Test {
             check(arm32 ? "vqrdmulh.s16" : "sqrdmulh", 4*w, i16_sat((i32(i16_1) * i32(i16_2) + (1<<14)) / (1 << 15)));
             check(arm32 ? "vqrdmulh.s32" : "sqrdmulh", 2*w, i32_sat((i64(i32_1) * i64(i32_2) + (1<<30)) /
                                                                     (Expr(int64_t(1)) << 31)));
+            check(arm32 ? "vqrdmulh.s16" : "sqrdmulh", 4*w, rounding_mul_shift_right(i16_1, i16_2, 15));
+            check(arm32 ? "vqrdmulh.s32" : "sqrdmulh", 2*w, rounding_mul_shift_right(i32_1, i32_2, 31));
 
             // VQRSHL   I       -       Saturating Rounding Shift Left
             // VQRSHRN  I       -       Saturating Rounding Shift Right Narrow
@@ -1212,6 +1280,8 @@ struct Test {
             check(arm32 ? "vrhadd.u16" : "urhadd", 4*w, u16((u32(u16_1) + u32(u16_2) + 1)/2));
             check(arm32 ? "vrhadd.s32" : "srhadd", 2*w, i32((i64(i32_1) + i64(i32_2) + 1)/2));
             check(arm32 ? "vrhadd.u32" : "urhadd", 2*w, u32((u64(u32_1) + u64(u32_2) + 1)/2));
+            check(arm32 ? "vrhadd.s8"  : "srhadd", 8*w, rounding_halving_add(i8_1, i8_2));
+            check(arm32 ? "vrhadd.u16" : "urhadd", 4*w, rounding_halving_add(u16_1, u16_2));
 
             // VRSHL    I       -       Rounding Shift Left
             // VRSHR    I       -       Rounding Shift Right
@@ -324,6 +324,42 @@ int main(int argc, char **argv) {
         }
     }
 
+    {
+        custom_malloc_size = 0;
+        Func f, g;
+        Param<int> radius;
+        RDom r(0, radius);
+
+        f(x, y) = x * y;
+        g(x, y) = sum(f(x, y + r));
+
+        // The footprint of f in y depends on a Param, so there's no
+        // constant fold factor. It should be folded by the footprint
+        // rounded up to a power of two at runtime.
+        f.store_root().compute_at(g, y);
+
+        g.set_custom_allocator(my_malloc, my_free);
+
+        radius.set(3);
+        Buffer<int> im = g.realize(100, 1000);
+
+        size_t expected_size = 100*4*sizeof(int) + sizeof(int);
+        if (custom_malloc_size == 0 || custom_malloc_size != expected_size) {
+            printf("Scratch space allocated was %d instead of %d\n", (int)custom_malloc_size, (int)expected_size);
+            return -1;
+        }
+
+        for (int y = 0; y < im.height(); y++) {
+            for (int x = 0; x < im.width(); x++) {
+                int correct = x * (3*y + 3);
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
     printf("Success!\n");
     return 0;
 }
@@ -0,0 +1,139 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+// Count the heap allocations made by a pipeline.
+int mallocs = 0;
+
+void *my_malloc(void *user_context, size_t x) {
+    mallocs++;
+    void *orig = malloc(x+32);
+    void *ptr = (void *)((((size_t)orig + 32) >> 5) << 5);
+    ((void **)ptr)[-1] = orig;
+    return ptr;
+}
+
+void my_free(void *user_context, void *ptr) {
+    free(((void**)ptr)[-1]);
+}
+
+// Make a pipeline with a scratch Func f computed per tile of g, with
+// a size that isn't known at compile time.
+int test(MemoryType memory_type, int *num_mallocs) {
+    Var x, y, xo, yo, xi, yi;
+    Param<int> k;
+    Func f, g;
+
+    Expr offset = clamp(k, 0, 3);
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) + f(x + offset, y);
+
+    g.tile(x, y, xo, yo, xi, yi, 8, 8);
+    f.compute_at(g, xo).store_in(memory_type);
+
+    g.set_custom_allocator(my_malloc, my_free);
+
+    k.set(2);
+    mallocs = 0;
+    Buffer<int> out = g.realize(64, 64);
+    *num_mallocs = mallocs;
+
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = 2 * (x + y) + 2;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (get_jit_target_from_environment().has_gpu_feature()) {
+        printf("Not running test on GPU targets\n");
+        return 0;
+    }
+
+    int heap_mallocs, stack_mallocs, per_task_mallocs;
+    if (test(MemoryType::Heap, &heap_mallocs) ||
+        test(MemoryType::Stack, &stack_mallocs) ||
+        test(MemoryType::PerTask, &per_task_mallocs)) {
+        return -1;
+    }
+
+    // One allocation of f per tile.
+    if (heap_mallocs != 64) {
+        printf("Heap storage made %d allocations instead of 64\n", heap_mallocs);
+        return -1;
+    }
+
+    // f's size is bounded by a constant, so it can go on the stack.
+    if (stack_mallocs != 0) {
+        printf("Stack storage made %d allocations instead of 0\n", stack_mallocs);
+        return -1;
+    }
+
+    // One allocation of f reused by every tile.
+    if (per_task_mallocs != 1) {
+        printf("PerTask storage made %d allocations instead of 1\n", per_task_mallocs);
+        return -1;
+    }
+
+    {
+        // A per-task Func whose realization is skipped shouldn't be
+        // allocated at all.
+        Var x, y, xo, yo, xi, yi;
+        Param<bool> use_f;
+        Param<int> k;
+        Func f, g;
+        f(x, y) = x + y;
+        g(x, y) = select(use_f, f(x, y) + f(x + clamp(k, 0, 3), y), 0);
+        g.tile(x, y, xo, yo, xi, yi, 8, 8);
+        f.compute_at(g, xo).store_in(MemoryType::PerTask);
+        g.set_custom_allocator(my_malloc, my_free);
+
+        k.set(2);
+        for (int used = 0; used < 2; used++) {
+            use_f.set(used != 0);
+            mallocs = 0;
+            g.realize(64, 64);
+            if (mallocs != used) {
+                printf("PerTask storage made %d allocations instead of %d\n", mallocs, used);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // A small Func that lives entirely in registers.
+        Var x, y;
+        Func f, g;
+        f(x, y) = x * y;
+        g(x, y) = f(x, y) + f(x + 1, y);
+        g.unroll(x, 4);
+        f.compute_at(g, x).unroll(x).store_in(MemoryType::Register);
+        g.set_custom_allocator(my_malloc, my_free);
+
+        mallocs = 0;
+        Buffer<int> out = g.realize(16, 16);
+        if (mallocs != 0) {
+            printf("Register storage made %d allocations\n", mallocs);
+            return -1;
+        }
+        for (int y = 0; y < out.height(); y++) {
+            for (int x = 0; x < out.width(); x++) {
+                int correct = x * y + (x + 1) * y;
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "Halide.h"
+#include "test/common/halide_test_dirs.h"
+#include <stdio.h>
+#include <fstream>
+#include <string>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the Funcs tagged for non-temporal stores.
+class CountNontemporalFuncs : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Call *op) {
+        if (op->is_intrinsic(Call::nontemporal_stores)) {
+            count += (int)op->args.size();
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    int count = 0;
+};
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    const int vec = target.natural_vector_size<float>();
+
+    Var x, y;
+    Func f, g, h;
+
+    // f is streamed out and read back by g, so its stores must be
+    // fenced before g runs.
+    f(x, y) = cast<float>(x + y);
+    g(x, y) = f(x, y) * 2.0f;
+    h(x, y) = {g(x, y) + 1.0f, cast<int>(g(x, y))};
+
+    f.compute_root().vectorize(x, vec).store_nontemporal();
+    g.compute_root().vectorize(x, vec);
+    h.vectorize(x, vec).store_nontemporal();
+
+    CountNontemporalFuncs *counter = new CountNontemporalFuncs;
+    h.add_custom_lowering_pass(counter);
+
+    const int W = vec * 32, H = 64;
+    Buffer<float> a(W, H);
+    Buffer<int> b(W, H);
+    h.realize({a, b});
+
+    // One buffer for f, and one for each of the outputs of h.
+    if (counter->count != 3) {
+        printf("%d buffers were marked for non-temporal stores instead of 3\n", counter->count);
+        return -1;
+    }
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            float correct_a = (x + y) * 2.0f + 1.0f;
+            int correct_b = (x + y) * 2;
+            if (a(x, y) != correct_a || b(x, y) != correct_b) {
+                printf("h(%d, %d) = {%f, %d} instead of {%f, %d}\n",
+                       x, y, a(x, y), b(x, y), correct_a, correct_b);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Streaming stores made by the tasks of a parallel loop run
+        // on worker threads, so each task must fence its own stores.
+        Func f, g;
+        f(x, y) = cast<float>(x * y);
+        g(x, y) = f(x, y) + f(x + vec, y);
+        f.compute_root().vectorize(x, vec).parallel(y).store_nontemporal();
+        g.vectorize(x, vec);
+
+        Buffer<float> out = g.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                float correct = (float)(x * y + (x + vec) * y);
+                if (out(x, y) != correct) {
+                    printf("g(%d, %d) = %f instead of %f\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+
+        if (target.arch == Target::X86) {
+            std::string asm_file = Internal::get_test_tmp_dir() + "store_nontemporal_parallel.s";
+            g.compile_to_assembly(asm_file, {}, "store_nontemporal_parallel", target);
+            std::ifstream in(asm_file);
+            std::string line;
+            bool in_task = false, task_fenced = false;
+            while (std::getline(in, line)) {
+                bool is_label = !line.empty() && line[0] != ' ' && line[0] != '\t' &&
+                    line[line.size() - 1] == ':';
+                if (is_label && line.find("par_for_") != std::string::npos) {
+                    in_task = true;
+                } else if (in_task && line.find(".Lfunc_end") != std::string::npos) {
+                    in_task = false;
+                } else if (in_task && line.find("sfence") != std::string::npos) {
+                    task_fenced = true;
+                }
+            }
+            if (!task_fenced) {
+                printf("The parallel task doesn't fence its streaming stores\n");
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -1,8 +1,35 @@
 #include "Halide.h"
 #include <stdio.h>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using namespace Halide;
 
+#ifndef _WIN32
+// Get some memory that sits either right after or right before an
+// inaccessible page, so that reading outside of it crashes.
+uint8_t *guarded_memory(size_t size, bool at_end) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t pages = (size + page - 1) / page;
+    uint8_t *mem = (uint8_t *)mmap(nullptr, (pages + 2) * page, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    mprotect(mem, page, PROT_NONE);
+    mprotect(mem + (pages + 1) * page, page, PROT_NONE);
+    return at_end ? mem + (pages + 1) * page - size : mem + page;
+}
+
+void *guarded_malloc(void *user_context, size_t x) {
+    return guarded_memory(x, true);
+}
+
+void guarded_free(void *user_context, void *ptr) {
+    // Leak it. The test is short.
+}
+#endif
+
 int main(int argc, char **argv) {
     Buffer<int8_t> im(1697);
 
@@ -27,5 +54,97 @@ int main(int argc, char **argv) {
 
     g.realize(425);
 
+    // Strided loads with stride three and four use the same
+    // technique, with the base shifted down to a multiple of the
+    // stride so that the loads of each channel are shared. Again the
+    // last load of an external buffer must be pushed backwards.
+    for (int stride = 3; stride <= 4; stride++) {
+        Buffer<uint8_t> in(stride * 67);
+        in.for_each_element([&](int x) { in(x) = (uint8_t)(x * 17); });
+
+        Func h;
+        Var c;
+        h(c, x) = in(stride*x + c);
+        h.bound(c, 0, stride).bound(x, 0, 67)
+            .reorder(x, c).unroll(c).vectorize(x, 16, TailStrategy::ShiftInwards);
+
+        Buffer<uint8_t> out = h.realize(stride, 67);
+        for (int x = 0; x < 67; x++) {
+            for (int c = 0; c < stride; c++) {
+                uint8_t correct = (uint8_t)((stride*x + c) * 17);
+                if (out(c, x) != correct) {
+                    printf("out(%d, %d) = %d instead of %d for stride %d\n",
+                           c, x, out(c, x), correct, stride);
+                    return -1;
+                }
+            }
+        }
+    }
+
+#ifndef _WIN32
+    for (int stride = 3; stride <= 4; stride++) {
+        // A strided load from an internal allocation may read into
+        // the element of padding at the end of it, but no further.
+        // Pick a size that fills the allocation out to a multiple of
+        // 32 bytes, so that the allocator can hand out aligned memory
+        // right up against a guard page.
+        const int N = stride == 3 ? 17 : 16;
+        const int W = stride * (N - 1) + 1;
+        int H = 1;
+        while ((W * H + 1) % 32) H++;
+
+        Func f, g;
+        Var y;
+        f(x, y) = cast<uint8_t>(x + y * 7);
+        g(x, y) = f(stride*x, y);
+        f.compute_root().store_in(MemoryType::Heap);
+        g.bound(x, 0, N).bound(y, 0, H).vectorize(x, 16, TailStrategy::ShiftInwards);
+        g.set_custom_allocator(guarded_malloc, guarded_free);
+
+        Buffer<uint8_t> out = g.realize(N, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < N; x++) {
+                uint8_t correct = (uint8_t)(stride*x + y * 7);
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d for stride %d\n",
+                           x, y, out(x, y), correct, stride);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    for (int stride = 3; stride <= 4; stride++) {
+        // A strided load from a cropped input, which starts at an
+        // odd coordinate. The constant in the index must not be used
+        // to line up the loads, because the element before the
+        // start of the input may not exist.
+        const int N = 17;
+        const int size = stride * (N - 1) + 1;
+        ImageParam in(UInt(8), 1);
+        Func h;
+        h(x) = in(stride*x + 1);
+        h.bound(x, 0, N).vectorize(x, 16, TailStrategy::ShiftInwards);
+
+        for (int at_end = 0; at_end < 2; at_end++) {
+            halide_dimension_t shape = {1, size, 1};
+            Buffer<uint8_t> input(guarded_memory(size, at_end), 1, &shape);
+            input.for_each_element([&](int x) { input(x) = (uint8_t)(x * 17); });
+            in.set(input);
+
+            Buffer<uint8_t> out = h.realize(N);
+            for (int x = 0; x < N; x++) {
+                uint8_t correct = (uint8_t)((stride*x + 1) * 17);
+                if (out(x) != correct) {
+                    printf("out(%d) = %d instead of %d for stride %d\n",
+                           x, out(x), correct, stride);
+                    return -1;
+                }
+            }
+        }
+    }
+#endif
+
+    printf("Success!\n");
     return 0;
 }
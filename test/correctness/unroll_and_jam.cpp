@@ -0,0 +1,108 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the stores in the innermost loop of the update. After
+// unrolling and jamming, each unrolled copy of the update should be in
+// there.
+class CountInnermostStores : public IRMutator {
+    using IRMutator::visit;
+
+    int stores = 0;
+    bool inner_loop = false;
+
+    void visit(const Store *op) {
+        stores++;
+        IRMutator::visit(op);
+    }
+
+    void visit(const For *op) {
+        int old_stores = stores;
+        stores = 0;
+        inner_loop = false;
+        IRMutator::visit(op);
+        if (!inner_loop && op->name.find(".s1.") != std::string::npos) {
+            innermost_stores = stores;
+        }
+        stores += old_stores;
+        inner_loop = true;
+    }
+
+public:
+    int innermost_stores = -1;
+};
+
+int main(int argc, char **argv) {
+    const int size = 64;
+
+    Buffer<float> a(size, size), b(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            a(x, y) = (float)((x + 3 * y) % 17);
+            b(x, y) = (float)((2 * x + y) % 13);
+        }
+    }
+
+    Var x, y;
+    RDom k(0, size);
+
+    {
+        // A matrix multiply, register-blocked by jamming four rows of
+        // the output into the reduction loop.
+        Func f;
+        f(x, y) = 0.0f;
+        f(x, y) += a(k, y) * b(x, k);
+
+        f.bound(x, 0, size).bound(y, 0, size);
+        f.update()
+            .vectorize(x, 8)
+            .unroll_and_jam(y, 4);
+
+        CountInnermostStores *counter = new CountInnermostStores;
+        f.add_custom_lowering_pass(counter);
+
+        Buffer<float> out = f.realize(size, size);
+
+        if (counter->innermost_stores != 4) {
+            printf("Expected 4 stores in the innermost loop, found %d\n", counter->innermost_stores);
+            return -1;
+        }
+
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float correct = 0.0f;
+                for (int i = 0; i < size; i++) {
+                    correct += a(i, y) * b(x, i);
+                }
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %f instead of %f\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // Jamming a pure loop of unknown size, with a tail.
+        Func g;
+        g(x, y) = x + y;
+        g(x, y) += x * y;
+        g.update().unroll_and_jam(y, 3, TailStrategy::GuardWithIf);
+
+        Buffer<int> out = g.realize(10, 10);
+        for (int y = 0; y < out.height(); y++) {
+            for (int x = 0; x < out.width(); x++) {
+                int correct = x + y + x * y;
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "Halide.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+using namespace Halide;
+
+// The distance in units in the last place between a float and a
+// more precise reference value. NaNs only match NaNs.
+int64_t ulp_error(float a, double reference) {
+    if (std::isnan(a) || std::isnan(reference)) {
+        return (std::isnan(a) && std::isnan(reference)) ? 0 : INT64_MAX;
+    }
+    float r = (float)reference;
+    int32_t ia, ir;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ir, &r, sizeof(ir));
+    // Map the sign-magnitude representation onto a monotonic one.
+    if (ia < 0) ia = INT32_MIN - ia;
+    if (ir < 0) ir = INT32_MIN - ir;
+    return std::abs((int64_t)ia - (int64_t)ir);
+}
+
+// Random values, preceded by some special values.
+Buffer<float> random_input(float lo, float hi, int seed, std::vector<float> special = {}) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    Buffer<float> in(4096);
+    in.for_each_value([&](float &v) { v = dist(rng); });
+    for (size_t i = 0; i < special.size(); i++) {
+        in((int)i) = special[i];
+    }
+    return in;
+}
+
+template<typename Ref>
+bool check(const char *name, Expr e, Var x, Buffer<float> a, Buffer<float> b,
+           int64_t max_ulps, Ref reference) {
+    Target target = get_jit_target_from_environment();
+    Func f;
+    f(x) = e;
+    f.vectorize(x, target.natural_vector_size<float>());
+    Buffer<float> out = f.realize(a.width());
+
+    int64_t worst = 0;
+    int worst_i = 0;
+    for (int i = 0; i < a.width(); i++) {
+        int64_t err = ulp_error(out(i), reference(a(i), b(i)));
+        if (err > worst) {
+            worst = err;
+            worst_i = i;
+        }
+    }
+    if (worst > max_ulps) {
+        printf("Error for %s exceeds %lld ulp: got %f instead of %f at (%f, %f)\n",
+               name, (long long)max_ulps, out(worst_i),
+               reference(a(worst_i), b(worst_i)), a(worst_i), b(worst_i));
+        return false;
+    }
+    printf("%s: worst error %lld ulp at (%f, %f)\n",
+           name, (long long)worst, a(worst_i), b(worst_i));
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature() || target.features_any_of({Target::HVX_64, Target::HVX_128})) {
+        printf("Not running vector transcendentals test on gpu or hexagon targets\n");
+        return 0;
+    }
+
+    Var x;
+
+    // Huge and non-finite arguments, which the polynomials can't
+    // reduce, should match the system library.
+    Buffer<float> trig_in =
+        random_input(-1000.0f, 1000.0f, 0,
+                     {1e10f, -1e10f, 3e38f, 32768.0f, -32768.0f, 32767.998f,
+                      INFINITY, -INFINITY, NAN, -0.0f});
+    Buffer<float> asin_in =
+        random_input(-1.0f, 1.0f, 1, {1.0f, -1.0f, 1.5f, -1e10f, INFINITY, NAN, -0.0f});
+    Buffer<float> atan_in =
+        random_input(-1000.0f, 1000.0f, 2, {1e10f, -3e38f, INFINITY, -INFINITY, NAN, -0.0f});
+
+    // Make sure we hit the special cases of atan2, including the
+    // signed zeros and infinities.
+    Buffer<float> grad_x =
+        random_input(-10.0f, 10.0f, 3,
+                     {0.0f, 1.0f, 0.0f, -1.0f, -1.0f, -0.0f, -0.0f,
+                      INFINITY, -INFINITY, INFINITY, -INFINITY,
+                      INFINITY, -INFINITY, 1.0f, NAN, -0.0f});
+    Buffer<float> grad_y =
+        random_input(-10.0f, 10.0f, 4,
+                     {1.0f, 0.0f, 0.0f, 0.0f, -0.0f, 0.0f, -0.0f,
+                      INFINITY, INFINITY, -INFINITY, -INFINITY,
+                      1.0f, -1.0f, INFINITY, 1.0f, NAN});
+
+    auto sin_ref = [](float a, float) { return std::sin((double)a); };
+    auto cos_ref = [](float a, float) { return std::cos((double)a); };
+    auto atan_ref = [](float a, float) { return std::atan((double)a); };
+    auto atan2_ref = [](float a, float b) { return std::atan2((double)a, (double)b); };
+
+    bool ok = true;
+
+    // The defaults are accurate to within a few ulp when vectorized.
+    ok &= check("sin", sin(trig_in(x)), x, trig_in, trig_in, 3, sin_ref);
+    ok &= check("cos", cos(trig_in(x)), x, trig_in, trig_in, 3, cos_ref);
+    ok &= check("tan", tan(trig_in(x)), x, trig_in, trig_in, 4,
+                [](float a, float) { return std::tan((double)a); });
+    ok &= check("asin", asin(asin_in(x)), x, asin_in, asin_in, 4,
+                [](float a, float) { return std::asin((double)a); });
+    ok &= check("acos", acos(asin_in(x)), x, asin_in, asin_in, 4,
+                [](float a, float) { return std::acos((double)a); });
+    ok &= check("atan", atan(atan_in(x)), x, atan_in, atan_in, 3, atan_ref);
+    ok &= check("atan2", atan2(grad_y(x), grad_x(x)), x, grad_y, grad_x, 4, atan2_ref);
+
+    // The fast versions trade accuracy for speed, down to the bound
+    // requested. They give NaN for the arguments they can't reduce.
+    auto fast_sin_ref = [](float a, float) {
+        return std::abs(a) < 32768.0f ? std::sin((double)a) : NAN;
+    };
+    auto fast_cos_ref = [](float a, float) {
+        return std::abs(a) < 32768.0f ? std::cos((double)a) : NAN;
+    };
+    ok &= check("fast_sin", fast_sin(trig_in(x)), x, trig_in, trig_in, 27, fast_sin_ref);
+    ok &= check("fast_cos", fast_cos(trig_in(x)), x, trig_in, trig_in, 27, fast_cos_ref);
+    ok &= check("fast_atan", fast_atan(atan_in(x)), x, atan_in, atan_in, 12, atan_ref);
+    ok &= check("fast_atan2", fast_atan2(grad_y(x), grad_x(x)), x, grad_y, grad_x, 13, atan2_ref);
+    ok &= check("fast_sin to 3 ulp", fast_sin(trig_in(x), 3), x, trig_in, trig_in, 3, fast_sin_ref);
+    ok &= check("fast_cos to 3 ulp", fast_cos(trig_in(x), 3), x, trig_in, trig_in, 3, fast_cos_ref);
+    ok &= check("fast_atan to 3 ulp", fast_atan(atan_in(x), 3), x, atan_in, atan_in, 3, atan_ref);
+    ok &= check("fast_atan2 to 4 ulp", fast_atan2(grad_y(x), grad_x(x), 4), x, grad_y, grad_x, 4, atan2_ref);
+
+    if (!ok) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Var x;
+    Param<int> p;
+
+    Func f, g;
+
+    f(x) = x;
+    g(x) = f(x) + f(x + p);
+    f.compute_root().store_in(MemoryType::Stack);
+
+    // The size of f depends on p, which could be anything.
+    p.set(10);
+    Buffer<int> im = g.realize(100);
+
+    printf("Should have gotten an error about an unbounded stack allocation!\n");
+    return -1;
+}
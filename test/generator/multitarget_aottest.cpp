@@ -98,6 +98,40 @@ int main(int argc, char **argv) {
         }
     }
 
+    {
+        // The memory footprint query gets a wrapper too. The output
+        // is the only Func, so nothing else needs memory.
+        Buffer<uint64_t> footprint(2);
+        footprint.fill(1);
+        int result = HalideTest::multitarget_memory_footprint(output, footprint);
+        if (result != 0 || footprint(0) != 0 || footprint(1) != 0) {
+            printf("Error: memory footprint query returned %d, with heap %llu and stack %llu\n",
+                   result, (unsigned long long)footprint(0), (unsigned long long)footprint(1));
+            return -1;
+        }
+
+        // The result buffer may be strided.
+        uint64_t strided_storage[4] = {1, 1, 1, 1};
+        halide_dimension_t strided_shape = {0, 2, 2};
+        Buffer<uint64_t> strided(strided_storage, 1, &strided_shape);
+        result = HalideTest::multitarget_memory_footprint(output, strided);
+        if (result != 0 || strided_storage[0] != 0 || strided_storage[1] != 1 ||
+            strided_storage[2] != 0 || strided_storage[3] != 1) {
+            printf("Error: strided memory footprint query returned %d, and wrote {%llu, %llu, %llu, %llu}\n",
+                   result, (unsigned long long)strided_storage[0], (unsigned long long)strided_storage[1],
+                   (unsigned long long)strided_storage[2], (unsigned long long)strided_storage[3]);
+            return -1;
+        }
+
+        // It needs room for both the heap and the stack size.
+        Buffer<uint64_t> too_small(1);
+        result = HalideTest::multitarget_memory_footprint(output, too_small);
+        if (result != halide_error_code_access_out_of_bounds) {
+            printf("Error: expected to fail with halide_error_code_access_out_of_bounds (%d) but actually got %d!\n", (int) halide_error_code_access_out_of_bounds, result);
+            return -1;
+        }
+    }
+
     printf("Success: Saw %x for debug=%d\n", output(0, 0), use_debug_feature());
 
     return 0;
@@ -0,0 +1,125 @@
+// Don't include Halide.h: it is not necessary for this test.
+#include "HalideBuffer.h"
+#include "benchmark.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Halide::Runtime;
+
+int main(int argc, char **argv) {
+    const int W = 3840, H = 2160;
+
+    bool ok = true;
+
+    {
+        // Copy a 4k frame into the middle of a larger canvas. Each
+        // row of the copy is dense in both buffers.
+        Buffer<uint8_t> frame(W, H, 3), canvas(W + 256, H + 256, 3);
+        frame.fill(17);
+        canvas.fill(0);
+        Buffer<uint8_t> window = canvas.cropped(0, 128, W).cropped(1, 128, H);
+        frame.set_min(128, 128);
+
+        double t_copy = benchmark(10, 1, [&]() {
+            canvas.copy_from(frame);
+        });
+
+        double t_element = benchmark(10, 1, [&]() {
+            window.for_each_element([&](int x, int y, int c) {
+                window(x, y, c) = frame(x, y, c);
+            });
+        });
+
+        double t_memcpy = benchmark(10, 1, [&]() {
+            for (int c = 0; c < 3; c++) {
+                for (int y = 128; y < 128 + H; y++) {
+                    memcpy(&window(128, y, c), &frame(128, y, c), W);
+                }
+            }
+        });
+
+        printf("Copy into canvas:\n"
+               "  copy_from:        %f ms\n"
+               "  for_each_element: %f ms\n"
+               "  memcpy per row:   %f ms\n",
+               t_copy * 1e3, t_element * 1e3, t_memcpy * 1e3);
+
+        // copy_from should be close to memcpy.
+        if (t_copy > t_memcpy * 2) {
+            printf("copy_from is much slower than memcpy\n");
+            ok = false;
+        }
+    }
+
+    {
+        // Convert a planar image to an interleaved one. The buffers
+        // are dense in different dimensions.
+        Buffer<float> planar(W / 2, H / 2, 4);
+        Buffer<float> interleaved = Buffer<float>::make_interleaved(W / 2, H / 2, 4);
+        planar.fill([&](int x, int y, int c) {return x + y * 2.0f + c;});
+
+        double t_copy = benchmark(10, 1, [&]() {
+            interleaved.copy_from(planar);
+        });
+
+        double t_value = benchmark(10, 1, [&]() {
+            interleaved.for_each_value([&](float &dst, float src) {dst = src;}, planar);
+        });
+
+        printf("Planar to interleaved:\n"
+               "  copy_from:      %f ms\n"
+               "  for_each_value: %f ms\n",
+               t_copy * 1e3, t_value * 1e3);
+    }
+
+    {
+        // Transpose a large matrix.
+        Buffer<uint16_t> a(4096, 4096), b(4096, 4096);
+        a.fill(3);
+        b.transpose(0, 1);
+
+        double t_copy = benchmark(5, 1, [&]() {
+            b.copy_from(a);
+        });
+
+        double t_value = benchmark(5, 1, [&]() {
+            b.for_each_value([&](uint16_t &dst, uint16_t src) {dst = src;}, a);
+        });
+
+        printf("Transpose:\n"
+               "  copy_from:      %f ms\n"
+               "  for_each_value: %f ms\n",
+               t_copy * 1e3, t_value * 1e3);
+
+        if (t_copy > t_value * 1.5) {
+            printf("Tiled transpose is slower than the naive one\n");
+            ok = false;
+        }
+    }
+
+    {
+        // Clear a crop of the canvas.
+        Buffer<float> canvas(W + 256, H + 256);
+        Buffer<float> window = canvas.cropped(0, 128, W).cropped(1, 128, H);
+
+        double t_fill = benchmark(10, 1, [&]() {
+            window.fill(0.0f);
+        });
+
+        double t_value = benchmark(10, 1, [&]() {
+            window.for_each_value([&](float &v) {v = 0.0f;});
+        });
+
+        printf("Fill with zero:\n"
+               "  fill:           %f ms\n"
+               "  for_each_value: %f ms\n",
+               t_fill * 1e3, t_value * 1e3);
+    }
+
+    if (!ok) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
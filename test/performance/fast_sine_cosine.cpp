@@ -0,0 +1,79 @@
+#include "Halide.h"
+#include <cstdio>
+#include <cmath>
+#include "benchmark.h"
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// The system sin, called once per lane.
+extern "C" DLLEXPORT float sin_ref(float x) {
+    return sinf(x);
+}
+HalideExtern_1(float, sin_ref, float);
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature() || target.features_any_of({Target::HVX_64, Target::HVX_128})) {
+        printf("Not running fast sine cosine benchmark on gpu or hexagon targets\n");
+        return 0;
+    }
+
+    Var x, y;
+    Expr arg = (x + y * 1024) / 1024.0f - 512.0f;
+
+    struct {
+        const char *name;
+        Expr e;
+        double max_error;
+    } tests[] = {
+        {"sin", sin(arg), 0.000001},
+        {"fast_sin to 3 ulp", fast_sin(arg, 3), 0.000001},
+        {"fast_sin", fast_sin(arg), 0.00001},
+    };
+
+    const int vec = target.natural_vector_size<float>();
+
+    Func f;
+    f(x, y) = sin_ref(arg);
+    f.vectorize(x, vec);
+    Buffer<float> correct_result(1024, 1024);
+    double t_ref = 1e3 * benchmark(3, 3, [&]() { f.realize(correct_result); });
+
+    int N = correct_result.width() * correct_result.height();
+    printf("sinf: %f ns per pixel\n", 1000000 * t_ref / N);
+
+    for (auto &test : tests) {
+        Func h;
+        h(x, y) = test.e;
+        h.vectorize(x, vec);
+        Buffer<float> result(1024, 1024);
+        double t = 1e3 * benchmark(10, 10, [&]() { h.realize(result); });
+
+        double err = 0;
+        correct_result.for_each_element([&](int x, int y) {
+            err = std::max(err, (double)std::abs(correct_result(x, y) - result(x, y)));
+        });
+
+        printf("Halide's %s: %f ns per pixel (max error = %0.10f)\n",
+               test.name, 1000000 * t / N, err);
+
+        if (err > test.max_error) {
+            printf("Error for %s too large\n", test.name);
+            return -1;
+        }
+
+        if (t > t_ref) {
+            printf("Halide's %s is slower than sinf\n", test.name);
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "Halide.h"
+#include <cstdio>
+#include "benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+const int W = 1024, H = 1024;
+
+// Count the loads from the input inside the loop over y, which is the
+// innermost serial loop in the schedules below.
+class CountInnerLoads : public IRMutator {
+    using IRMutator::visit;
+
+    bool in_y_loop = false;
+
+    void visit(const For *op) {
+        bool old = in_y_loop;
+        in_y_loop = in_y_loop || ends_with(op->name, ".y");
+        mutate(op->body);
+        in_y_loop = old;
+        stmt = op;
+    }
+
+    void visit(const Load *op) {
+        if (in_y_loop && op->name == "input") {
+            loads++;
+        }
+        IRMutator::visit(op);
+    }
+
+public:
+    int loads = 0;
+};
+
+struct Result {
+    int loads;
+    double time;
+};
+
+Result test(Buffer<uint16_t> input, int radius, bool carry) {
+    Var x, y, xo, xi;
+    Func box;
+    Expr e = cast<uint32_t>(0);
+    for (int dy = -radius; dy <= radius; dy++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            e += cast<uint32_t>(input(x + dx, y + dy));
+        }
+    }
+    box(x, y) = e;
+
+    Target t = get_jit_target_from_environment();
+    if (carry) {
+        t = t.with_feature(Target::LoopCarry);
+    }
+
+    // Walk down columns of vectors, so that each iteration of y
+    // reloads rows loaded by the previous one.
+    const int vec = t.natural_vector_size<uint32_t>();
+    box.split(x, xo, xi, vec).reorder(xi, y, xo).vectorize(xi);
+
+    CountInnerLoads *counter = new CountInnerLoads;
+    box.add_custom_lowering_pass(counter, nullptr);
+    box.compile_jit(t);
+
+    Buffer<uint32_t> out(W, H);
+    box.realize(out);
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint32_t correct = 0;
+            for (int dy = -radius; dy <= radius; dy++) {
+                for (int dx = -radius; dx <= radius; dx++) {
+                    correct += input(x + dx, y + dy);
+                }
+            }
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                exit(-1);
+            }
+        }
+    }
+
+    Result result;
+    result.loads = counter->loads;
+    result.time = benchmark(10, 10, [&]() { box.realize(out); });
+    delete counter;
+    return result;
+}
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.has_gpu_feature() || target.arch == Target::Hexagon) {
+        printf("Not running loop carry test on gpu or hexagon targets\n");
+        return 0;
+    }
+
+    for (int radius = 1; radius <= 2; radius++) {
+        Buffer<uint16_t> input(W + 2*radius, H + 2*radius, "input");
+        input.set_min(-radius, -radius);
+        input.for_each_value([](uint16_t &v) { v = rand() & 0xfff; });
+
+        Result reloaded = test(input, radius, false);
+        Result carried = test(input, radius, true);
+
+        int size = 2 * radius + 1;
+        printf("%dx%d box filter:\n"
+               "  Without loop carry: %d loads per iteration, %f ms\n"
+               "  With loop carry:    %d loads per iteration, %f ms\n",
+               size, size,
+               reloaded.loads, reloaded.time * 1e3,
+               carried.loads, carried.time * 1e3);
+
+        if (carried.loads >= reloaded.loads) {
+            printf("Loop carry did not reduce the number of loads\n");
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
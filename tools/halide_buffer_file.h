@@ -0,0 +1,343 @@
+// A simple binary file format for Halide::Runtime::Buffer, designed
+// so that files can be memory-mapped and used in place without any
+// decoding or copying.
+//
+// A file consists of a fixed-size header describing the type and
+// shape of the buffer, followed by the payload, which starts at a
+// page-aligned offset. Data is stored in host byte order, and the
+// header records which order that was.
+
+#ifndef HALIDE_BUFFER_FILE_H
+#define HALIDE_BUFFER_FILE_H
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "HalideBuffer.h"
+
+namespace Halide {
+namespace Tools {
+
+namespace Internal {
+
+typedef bool (*BufferFileCheckFunc)(bool condition, const char* fmt, ...);
+
+inline bool BufferFileCheckFail(bool condition, const char* fmt, ...) {
+    if (!condition) {
+        char buffer[1024];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buffer, sizeof(buffer), fmt, args);
+        va_end(args);
+        fprintf(stderr, "%s", buffer);
+        exit(-1);
+    }
+    return condition;
+}
+
+inline bool BufferFileCheckReturn(bool condition, const char* fmt, ...) {
+    return condition;
+}
+
+const int buffer_file_max_dimensions = 16;
+const uint32_t buffer_file_version = 1;
+const uint32_t buffer_file_byte_order = 0x01020304;
+// The payload is aligned to this, so that it is page-aligned when
+// the whole file is mapped.
+const uint64_t buffer_file_payload_alignment = 4096;
+
+struct BufferFileHeader {
+    char magic[4];
+    uint32_t version;
+    // buffer_file_byte_order, as written by the host that made the file.
+    uint32_t byte_order;
+    uint8_t type_code, type_bits;
+    uint16_t type_lanes;
+    int32_t dimensions;
+    // In elements.
+    int32_t min[buffer_file_max_dimensions];
+    int32_t extent[buffer_file_max_dimensions];
+    int32_t stride[buffer_file_max_dimensions];
+    // In bytes, from the start of the file.
+    uint64_t payload_offset, payload_size;
+};
+
+inline bool is_buffer_file_magic(const char *magic) {
+    return memcmp(magic, "HLBF", 4) == 0;
+}
+
+// Check a header is one we can read, and that the elements it
+// describes all lie within the payload.
+template<BufferFileCheckFunc check>
+bool check_buffer_file_header(const BufferFileHeader &h, uint64_t file_size, const std::string &filename) {
+    if (!check(is_buffer_file_magic(h.magic), "%s is not a Halide buffer file\n", filename.c_str())) return false;
+    if (!check(h.version == buffer_file_version, "%s has unknown version %u\n", filename.c_str(), h.version)) return false;
+    if (!check(h.byte_order == buffer_file_byte_order, "%s was written with a different byte order\n", filename.c_str())) return false;
+    if (!check(h.dimensions >= 0 && h.dimensions <= buffer_file_max_dimensions,
+               "%s has bad dimensionality %d\n", filename.c_str(), h.dimensions)) return false;
+    if (!check(h.payload_offset <= file_size && h.payload_size <= file_size - h.payload_offset,
+               "%s is truncated\n", filename.c_str())) return false;
+
+    int64_t elem_size = (h.type_bits + 7) / 8 * (int64_t)h.type_lanes;
+    int64_t min_offset = 0, max_offset = 0;
+    for (int i = 0; i < h.dimensions; i++) {
+        if (!check(h.extent[i] > 0, "%s has an empty dimension\n", filename.c_str())) return false;
+        int64_t span = (int64_t)h.stride[i] * (h.extent[i] - 1);
+        if (span < 0) {
+            min_offset += span;
+        } else {
+            max_offset += span;
+        }
+    }
+    return check(min_offset >= 0 && (uint64_t)((max_offset + 1) * elem_size) <= h.payload_size,
+                 "%s has a shape that doesn't fit in its payload\n", filename.c_str());
+}
+
+struct MappedBufferFile : public Halide::Runtime::AllocationHeader {
+    void *addr;
+    size_t length;
+};
+
+#ifdef _WIN32
+inline void free_buffer_file(void *ptr) {
+    MappedBufferFile *m = (MappedBufferFile *)ptr;
+    free(m->addr);
+    delete m;
+}
+#else
+inline void unmap_buffer_file(void *ptr) {
+    MappedBufferFile *m = (MappedBufferFile *)ptr;
+    munmap(m->addr, m->length);
+    delete m;
+}
+#endif
+
+}  // namespace Internal
+
+// Map a buffer file into memory and wrap it in a Buffer without
+// copying. Pages are read in lazily as they are touched, and the
+// mapping is released when the last Buffer referring to it is
+// destroyed. If T is const the mapping is read-only. Otherwise it is
+// private and copy-on-write, so changes are not written back to the
+// file. On Windows, the file is read into a new allocation instead.
+template<typename T, int D, Internal::BufferFileCheckFunc check = Internal::BufferFileCheckReturn>
+bool map_buffer_file(const std::string &filename, Halide::Runtime::Buffer<T, D> *buf) {
+    using namespace Internal;
+    typedef Halide::Runtime::Buffer<T, D> BufferType;
+
+    FILE *f = fopen(filename.c_str(), "rb");
+    if (!check(f != nullptr, "File %s could not be opened for reading\n", filename.c_str())) return false;
+    BufferFileHeader h;
+    bool ok = check(fread(&h, sizeof(h), 1, f) == 1, "%s is too short to be a buffer file\n", filename.c_str());
+    fseek(f, 0, SEEK_END);
+    uint64_t file_size = ftell(f);
+    ok = ok && check_buffer_file_header<check>(h, file_size, filename);
+    ok = ok && check(h.dimensions <= D, "%s has %d dimensions, but the Buffer supports at most %d\n",
+                     filename.c_str(), h.dimensions, D);
+
+    halide_type_t type((halide_type_code_t)h.type_code, h.type_bits, h.type_lanes);
+    if (ok && BufferType::has_static_halide_type()) {
+        ok = check(type == BufferType::static_halide_type(), "%s has the wrong type\n", filename.c_str());
+    }
+
+    halide_dimension_t shape[buffer_file_max_dimensions];
+    for (int i = 0; ok && i < h.dimensions; i++) {
+        shape[i].min = h.min[i];
+        shape[i].extent = h.extent[i];
+        shape[i].stride = h.stride[i];
+    }
+
+#ifdef _WIN32
+    // No mmap, so read the payload into an allocation we manage the
+    // same way.
+    MappedBufferFile *m = nullptr;
+    if (ok) {
+        m = new MappedBufferFile;
+        m->deallocate_fn = free_buffer_file;
+        m->ref_count = 0;
+        m->length = (size_t)h.payload_size;
+        m->addr = malloc(m->length);
+        fseek(f, (long)h.payload_offset, SEEK_SET);
+        ok = check(fread(m->addr, 1, m->length, f) == m->length,
+                   "Could not read payload of %s\n", filename.c_str());
+    }
+    fclose(f);
+    if (!ok) {
+        if (m) free_buffer_file(m);
+        return false;
+    }
+    *buf = BufferType(type, m->addr, h.dimensions, shape);
+    buf->adopt_allocation(m);
+    return true;
+#else
+    fclose(f);
+    if (!ok) return false;
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (!check(fd >= 0, "File %s could not be opened for reading\n", filename.c_str())) return false;
+    const bool writable = !std::is_const<T>::value;
+    void *addr = mmap(nullptr, file_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive.
+    close(fd);
+    if (!check(addr != MAP_FAILED, "Could not map %s\n", filename.c_str())) return false;
+
+    MappedBufferFile *m = new MappedBufferFile;
+    m->deallocate_fn = unmap_buffer_file;
+    m->ref_count = 0;
+    m->addr = addr;
+    m->length = file_size;
+    uint8_t *payload = (uint8_t *)addr + h.payload_offset;
+    *buf = BufferType(type, payload, h.dimensions, shape);
+    buf->adopt_allocation(m);
+    return true;
+#endif
+}
+
+template<typename T = void, int D = 4>
+Halide::Runtime::Buffer<T, D> map_buffer_file(const std::string &filename) {
+    Halide::Runtime::Buffer<T, D> buf;
+    map_buffer_file<T, D, Internal::BufferFileCheckFail>(filename, &buf);
+    return buf;
+}
+
+// Writes a buffer file incrementally, so that a large buffer can be
+// produced and saved in pieces without ever being resident in memory
+// all at once. Pieces must be written in order along the last
+// dimension, and each must span the full extent of the other
+// dimensions. Elements are stored densely, with the first dimension
+// innermost.
+template<Internal::BufferFileCheckFunc check = Internal::BufferFileCheckReturn>
+class BufferFileWriter {
+    FILE *f = nullptr;
+    std::string filename;
+    Internal::BufferFileHeader header;
+    // The next coordinate expected in the last dimension.
+    int next = 0;
+
+public:
+    BufferFileWriter(const std::string &filename, halide_type_t type,
+                     const std::vector<int> &mins, const std::vector<int> &extents) : filename(filename) {
+        using namespace Internal;
+        if (!check(mins.size() == extents.size() && (int)extents.size() <= buffer_file_max_dimensions,
+                   "Bad shape for buffer file %s\n", filename.c_str())) return;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "HLBF", 4);
+        header.version = buffer_file_version;
+        header.byte_order = buffer_file_byte_order;
+        header.type_code = type.code;
+        header.type_bits = type.bits;
+        header.type_lanes = type.lanes;
+        header.dimensions = (int)extents.size();
+        uint64_t size = type.bytes();
+        for (int i = 0; i < header.dimensions; i++) {
+            header.min[i] = mins[i];
+            header.extent[i] = extents[i];
+            header.stride[i] = (int32_t)(size / type.bytes());
+            size *= extents[i];
+        }
+        header.payload_offset = (sizeof(header) + buffer_file_payload_alignment - 1) & ~(buffer_file_payload_alignment - 1);
+        header.payload_size = size;
+        next = header.dimensions > 0 ? mins.back() : 0;
+
+        f = fopen(filename.c_str(), "wb");
+        if (!check(f != nullptr, "File %s could not be opened for writing\n", filename.c_str())) return;
+        std::vector<char> padding(header.payload_offset - sizeof(header), 0);
+        if (!check(fwrite(&header, sizeof(header), 1, f) == 1 &&
+                   fwrite(padding.data(), 1, padding.size(), f) == padding.size(),
+                   "Could not write header of %s\n", filename.c_str())) {
+            fclose(f);
+            f = nullptr;
+        }
+    }
+
+    ~BufferFileWriter() {
+        close();
+    }
+
+    // Write the next piece of the buffer.
+    template<typename T, int D>
+    bool write(const Halide::Runtime::Buffer<T, D> &piece) {
+        using namespace Internal;
+        if (!check(f != nullptr, "Buffer file %s is not open\n", filename.c_str())) return false;
+        int d = header.dimensions;
+        bool ok = check(piece.dimensions() == d &&
+                        piece.type().bytes() == (header.type_bits + 7) / 8 * header.type_lanes,
+                        "Piece written to %s has the wrong type or dimensionality\n", filename.c_str());
+        for (int i = 0; ok && i < d - 1; i++) {
+            ok = check(piece.dim(i).min() == header.min[i] && piece.dim(i).extent() == header.extent[i],
+                       "Piece written to %s doesn't span dimension %d\n", filename.c_str(), i);
+        }
+        ok = ok && check(d == 0 || (piece.dim(d - 1).min() == next &&
+                                    piece.dim(d - 1).max() < header.min[d - 1] + header.extent[d - 1]),
+                         "Piece written to %s is out of order\n", filename.c_str());
+        if (!ok) return false;
+
+        // Make a dense copy if necessary.
+        bool dense = true;
+        int64_t stride = 1;
+        for (int i = 0; i < d; i++) {
+            dense &= piece.dim(i).stride() == stride;
+            stride *= piece.dim(i).extent();
+        }
+        Halide::Runtime::Buffer<const T, D> src = piece;
+        if (!dense) {
+            std::vector<int> sizes;
+            for (int i = 0; i < d; i++) {
+                sizes.push_back(piece.dim(i).extent());
+            }
+            Halide::Runtime::Buffer<typename std::remove_const<T>::type, D> tmp(piece.type(), sizes);
+            for (int i = 0; i < d; i++) {
+                tmp.translate(i, piece.dim(i).min());
+            }
+            tmp.copy_from(piece);
+            src = tmp;
+        }
+
+        size_t bytes = src.size_in_bytes();
+        if (!check(fwrite(src.data(), 1, bytes, f) == bytes, "Could not write to %s\n", filename.c_str())) return false;
+        if (d > 0) {
+            next += piece.dim(d - 1).extent();
+        }
+        return true;
+    }
+
+    // Finish writing the file. Fails if not all of the buffer was
+    // written.
+    bool close() {
+        if (!f) return false;
+        int d = header.dimensions;
+        bool complete = d == 0 || next == header.min[d - 1] + header.extent[d - 1];
+        bool ok = fclose(f) == 0;
+        f = nullptr;
+        return check(ok && complete, "Buffer file %s is incomplete\n", filename.c_str());
+    }
+};
+
+// Save a whole buffer to a buffer file.
+template<typename T, int D, Internal::BufferFileCheckFunc check = Internal::BufferFileCheckReturn>
+bool save_buffer_file(const Halide::Runtime::Buffer<T, D> &buf, const std::string &filename) {
+    std::vector<int> mins, extents;
+    for (int i = 0; i < buf.dimensions(); i++) {
+        mins.push_back(buf.dim(i).min());
+        extents.push_back(buf.dim(i).extent());
+    }
+    BufferFileWriter<check> writer(filename, buf.type(), mins, extents);
+    return writer.write(buf) && writer.close();
+}
+
+}  // namespace Tools
+}  // namespace Halide
+
+#endif  // HALIDE_BUFFER_FILE_H
@@ -5,10 +5,13 @@
 #define HALIDE_IMAGE_IO_H
 
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef HALIDE_NO_PNG
@@ -119,6 +122,160 @@ struct FileOpener {
     FILE * const f;
 };
 
+// The rectangle of an image that a codec reads or writes, described
+// by the address of its first element and its strides, so that rows
+// can be converted without going through the image's operator().
+template<typename T>
+struct ImageRegion {
+    T *base;
+    int x_min, y_min, c_min;
+    int width, height, channels;
+    ptrdiff_t x_stride, y_stride, c_stride;
+
+    T *row(int y) const {
+        return base + (y - y_min) * y_stride;
+    }
+};
+
+template<typename ImageType>
+ImageRegion<typename ImageType::ElemType> get_region(ImageType &im) {
+    ImageRegion<typename ImageType::ElemType> r;
+    r.base = (typename ImageType::ElemType *)im.data();
+    r.x_min = im.dim(0).min();
+    r.width = im.dim(0).extent();
+    r.x_stride = im.dim(0).stride();
+    r.y_min = im.dim(1).min();
+    r.height = im.dim(1).extent();
+    r.y_stride = im.dim(1).stride();
+    if (im.dimensions() > 2) {
+        r.c_min = im.dim(2).min();
+        r.channels = im.dim(2).extent();
+        r.c_stride = im.dim(2).stride();
+    } else {
+        r.c_min = 0;
+        r.channels = 1;
+        r.c_stride = 0;
+    }
+    return r;
+}
+
+// Deinterleave one channel of a row. The channel count is a template
+// parameter so that the compiler can vectorize the loop.
+template<int src_channels, typename SrcType, typename DstType>
+inline void convert_channel(const SrcType *src, DstType *dst, int width) {
+    for (int x = 0; x < width; x++) {
+        convert(src[x * src_channels], dst[x]);
+    }
+}
+
+template<int dst_channels, typename SrcType, typename DstType>
+inline void interleave_channel(const SrcType *src, DstType *dst, int width) {
+    for (int x = 0; x < width; x++) {
+        convert(src[x], dst[x * dst_channels]);
+    }
+}
+
+// Convert a row of interleaved samples with src_channels channels,
+// starting at channel c_min, into row 'dst' of the region r.
+template<typename SrcType, typename DstType>
+void convert_from_interleaved(const SrcType *src, int src_channels, int c_min,
+                              const ImageRegion<DstType> &r, DstType *dst) {
+    src += c_min;
+    if (r.channels == src_channels && r.x_stride == r.channels &&
+        (r.channels == 1 || r.c_stride == 1)) {
+        // Interleaved to interleaved
+        for (int i = 0; i < r.width * r.channels; i++) {
+            convert(src[i], dst[i]);
+        }
+    } else if (r.x_stride == 1) {
+        // Interleaved to planar
+        for (int c = 0; c < r.channels; c++) {
+            switch (src_channels) {
+            case 1: convert_channel<1>(src + c, dst + c * r.c_stride, r.width); break;
+            case 2: convert_channel<2>(src + c, dst + c * r.c_stride, r.width); break;
+            case 3: convert_channel<3>(src + c, dst + c * r.c_stride, r.width); break;
+            case 4: convert_channel<4>(src + c, dst + c * r.c_stride, r.width); break;
+            default:
+                for (int x = 0; x < r.width; x++) {
+                    convert(src[x * src_channels + c], dst[c * r.c_stride + x]);
+                }
+            }
+        }
+    } else {
+        for (int x = 0; x < r.width; x++) {
+            for (int c = 0; c < r.channels; c++) {
+                convert(src[x * src_channels + c], dst[x * r.x_stride + c * r.c_stride]);
+            }
+        }
+    }
+}
+
+// Convert row 'src' of the region r into interleaved samples.
+template<typename SrcType, typename DstType>
+void convert_to_interleaved(const ImageRegion<SrcType> &r, const SrcType *src, DstType *dst) {
+    if (r.x_stride == r.channels && (r.channels == 1 || r.c_stride == 1)) {
+        // Interleaved to interleaved
+        for (int i = 0; i < r.width * r.channels; i++) {
+            convert(src[i], dst[i]);
+        }
+    } else if (r.x_stride == 1) {
+        // Planar to interleaved
+        for (int c = 0; c < r.channels; c++) {
+            switch (r.channels) {
+            case 2: interleave_channel<2>(src + c * r.c_stride, dst + c, r.width); break;
+            case 3: interleave_channel<3>(src + c * r.c_stride, dst + c, r.width); break;
+            case 4: interleave_channel<4>(src + c * r.c_stride, dst + c, r.width); break;
+            default:
+                for (int x = 0; x < r.width; x++) {
+                    convert(src[c * r.c_stride + x], dst[x * r.channels + c]);
+                }
+            }
+        }
+    } else {
+        for (int x = 0; x < r.width; x++) {
+            for (int c = 0; c < r.channels; c++) {
+                convert(src[x * r.x_stride + c * r.c_stride], dst[x * r.channels + c]);
+            }
+        }
+    }
+}
+
+template<typename T, CheckFunc check>
+bool check_region_in_file(const ImageRegion<T> &r, int width, int height, int channels) {
+    return check(r.x_min >= 0 && r.x_min + r.width <= width &&
+                 r.y_min >= 0 && r.y_min + r.height <= height &&
+                 r.c_min >= 0 && r.c_min + r.channels <= channels,
+                 "Image region [%d, %d] x [%d, %d] x [%d, %d] is outside the file, "
+                 "which is %d x %d x %d\n",
+                 r.x_min, r.x_min + r.width - 1, r.y_min, r.y_min + r.height - 1,
+                 r.c_min, r.c_min + r.channels - 1, width, height, channels);
+}
+
+// Call f(i) for each i in [0, n), on up to num_threads threads. If
+// num_threads is zero, use one per core.
+template<typename Fn>
+void parallel_for_each_file(int n, int num_threads, Fn f) {
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+    }
+    num_threads = std::max(1, std::min(num_threads, n));
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        int i;
+        while ((i = next++) < n) {
+            f(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+
 #ifndef HALIDE_NO_PNG
 struct PngRowPointers {
     PngRowPointers(int height, int rowbytes) : p(new png_bytep[height]), height(height) {
@@ -139,23 +296,19 @@ struct PngRowPointers {
     png_bytep* const p;
     int const height;
 };
-#endif // HALIDE_NO_PNG
-
-}  // namespace Internal
-
 
-template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
-bool load_png(const std::string &filename, ImageType *im) {
-#ifdef HALIDE_NO_PNG
-    check(false, "png not supported in this build\n");
-    return false;
-#else // HALIDE_NO_PNG
+// Decode the part of a png covered by *im into *im. If allocate is
+// true, *im is first replaced with an image the size of the file.
+// Rows are decoded one at a time, and decoding stops after the last
+// row of the region. Interlaced files are decoded whole.
+template<typename ImageType, CheckFunc check>
+bool load_png_region(const std::string &filename, ImageType *im, bool allocate) {
     png_byte header[8];
     png_structp png_ptr;
     png_infop info_ptr;
 
     /* open file and test for it being a png */
-    Internal::FileOpener f(filename.c_str(), "rb");
+    FileOpener f(filename.c_str(), "rb");
     if (!check(f.f != nullptr, "File %s could not be opened for reading\n", filename.c_str())) return false;
     if (!check(fread(header, 1, 8, f.f) == 8, "File ended before end of header\n")) return false;
     if (!check(!png_sig_cmp(header, 0, 8), "File %s is not recognized as a PNG file\n", filename.c_str())) return false;
@@ -180,53 +333,52 @@ bool load_png(const std::string &filename, ImageType *im) {
     int channels = png_get_channels(png_ptr, info_ptr);
     int bit_depth = png_get_bit_depth(png_ptr, info_ptr);
 
-    // Expand low-bpp images to have only 1 pixel per byte (As opposed to tight packing)
-    if (bit_depth < 8) {
-        png_set_packing(png_ptr);
-    }
+    if (!check((bit_depth == 8) || (bit_depth == 16), "Can only handle 8-bit or 16-bit pngs\n")) return false;
 
-    if (channels != 1) {
-        *im = ImageType(width, height, channels);
-    } else {
-        *im = ImageType(width, height);
+    // Have libpng produce 16-bit samples in the native byte order.
+    if (bit_depth == 16 && is_little_endian()) {
+        png_set_swap(png_ptr);
     }
 
-    png_set_interlace_handling(png_ptr);
+    int passes = png_set_interlace_handling(png_ptr);
     png_read_update_info(png_ptr, info_ptr);
 
+    if (allocate) {
+        if (channels != 1) {
+            *im = ImageType(width, height, channels);
+        } else {
+            *im = ImageType(width, height);
+        }
+    }
+
+    ImageRegion<typename ImageType::ElemType> r = get_region(*im);
+    if (!check_region_in_file<typename ImageType::ElemType, check>(r, width, height, channels)) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        return false;
+    }
+
+    PngRowPointers row_pointers(passes > 1 ? height : 1, png_get_rowbytes(png_ptr, info_ptr));
+
     // read the file
     if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error during read_image\n")) return false;
 
-    Internal::PngRowPointers row_pointers(im->height(), png_get_rowbytes(png_ptr, info_ptr));
-    png_read_image(png_ptr, row_pointers.p);
-
-    if (!check((bit_depth == 8) || (bit_depth == 16), "Can only handle 8-bit or 16-bit pngs\n")) return false;
+    if (passes > 1) {
+        png_read_image(png_ptr, row_pointers.p);
+    }
 
     // convert the data to ImageType::ElemType
-
-    int c_stride = (im->channels() == 1) ? 0 : ((&(*im)(0, 0, 1)) - (&(*im)(0, 0, 0)));
-    typename ImageType::ElemType *ptr = (typename ImageType::ElemType*)im->data();
-    if (bit_depth == 8) {
-        for (int y = 0; y < im->height(); y++) {
-            uint8_t *srcPtr = (uint8_t *)(row_pointers.p[y]);
-            for (int x = 0; x < im->width(); x++) {
-                for (int c = 0; c < im->channels(); c++) {
-                    Internal::convert(*srcPtr++, ptr[c*c_stride]);
-                }
-                ptr++;
-            }
+    for (int y = 0; y < r.y_min + r.height; y++) {
+        png_bytep row = row_pointers.p[0];
+        if (passes > 1) {
+            row = row_pointers.p[y];
+        } else {
+            png_read_row(png_ptr, row, NULL);
         }
-    } else if (bit_depth == 16) {
-        for (int y = 0; y < im->height(); y++) {
-            uint8_t *srcPtr = (uint8_t *)(row_pointers.p[y]);
-            for (int x = 0; x < im->width(); x++) {
-                for (int c = 0; c < im->channels(); c++) {
-                    uint16_t hi = (*srcPtr++) << 8;
-                    uint16_t lo = hi | (*srcPtr++);
-                    Internal::convert(lo, ptr[c*c_stride]);
-                }
-                ptr++;
-            }
+        if (y < r.y_min) continue;
+        if (bit_depth == 8) {
+            convert_from_interleaved((const uint8_t *)row + r.x_min * channels, channels, r.c_min, r, r.row(y));
+        } else {
+            convert_from_interleaved((const uint16_t *)row + r.x_min * channels, channels, r.c_min, r, r.row(y));
         }
     }
 
@@ -234,6 +386,110 @@ bool load_png(const std::string &filename, ImageType *im) {
 
     im->set_host_dirty();
     return true;
+}
+#endif // HALIDE_NO_PNG
+
+#ifndef HALIDE_NO_JPEG
+// Decode the part of a jpg covered by *im into *im. If allocate is
+// true, *im is first replaced with an image the size of the file.
+// With libjpeg-turbo, the rows above the region are skipped and only
+// the columns of the region are decoded. Either way, decoding stops
+// after the last row of the region.
+template<typename ImageType, CheckFunc check>
+bool load_jpg_region(const std::string &filename, ImageType *im, bool allocate) {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+
+    FileOpener f(filename.c_str(), "rb");
+    if (!check(f.f != nullptr,
+               "File %s could not be opened for reading\n", filename.c_str())) {
+        return false;
+    }
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, f.f);
+
+    jpeg_read_header(&cinfo, TRUE);
+    jpeg_start_decompress(&cinfo);
+
+    int width = cinfo.output_width;
+    int height = cinfo.output_height;
+    int channels = cinfo.output_components;
+    if (allocate) {
+        if (channels > 1) {
+            *im = ImageType(width, height, channels);
+        } else {
+            *im = ImageType(width, height);
+        }
+    }
+
+    ImageRegion<typename ImageType::ElemType> r = get_region(*im);
+    if (!check_region_in_file<typename ImageType::ElemType, check>(r, width, height, channels)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+
+    JDIMENSION x_offset = 0;
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+    if (r.width < width) {
+        // Rounds x_offset down to an iMCU boundary, and widens the
+        // crop to match.
+        JDIMENSION crop_width = r.width;
+        x_offset = r.x_min;
+        jpeg_crop_scanline(&cinfo, &x_offset, &crop_width);
+    }
+    if (r.y_min > 0) {
+        jpeg_skip_scanlines(&cinfo, r.y_min);
+    }
+#endif
+
+    std::vector<JSAMPLE> row(cinfo.output_width * channels);
+
+    while ((int)cinfo.output_scanline < r.y_min + r.height) {
+        int y = cinfo.output_scanline;
+        JSAMPROW row_ptr = row.data();
+        jpeg_read_scanlines(&cinfo, &row_ptr, 1);
+        if (y >= r.y_min) {
+            convert_from_interleaved(row.data() + (r.x_min - x_offset) * channels, channels, r.c_min, r, r.row(y));
+        }
+    }
+
+    if (cinfo.output_scanline == cinfo.output_height) {
+        jpeg_finish_decompress(&cinfo);
+    }
+    jpeg_destroy_decompress(&cinfo);
+
+    im->set_host_dirty();
+    return true;
+}
+#endif // HALIDE_NO_JPEG
+
+}  // namespace Internal
+
+
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_png(const std::string &filename, ImageType *im) {
+#ifdef HALIDE_NO_PNG
+    check(false, "png not supported in this build\n");
+    return false;
+#else // HALIDE_NO_PNG
+    return Internal::load_png_region<ImageType, check>(filename, im, true);
+#endif // HALIDE_NO_PNG
+}
+
+// Decode the part of a png covered by the already-allocated image *im
+// directly into it. The coordinates of *im are pixel coordinates in the
+// file, so cropping *im to a region decodes just that region, and *im
+// may have any memory layout (e.g. planar or interleaved). A two
+// dimensional *im receives the first channel of the file.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_png_into(const std::string &filename, ImageType *im) {
+#ifdef HALIDE_NO_PNG
+    check(false, "png not supported in this build\n");
+    return false;
+#else // HALIDE_NO_PNG
+    return Internal::load_png_region<ImageType, check>(filename, im, false);
 #endif // HALIDE_NO_PNG
 }
 
@@ -287,46 +543,26 @@ bool save_png(ImageType &im, const std::string &filename) {
 
     png_write_info(png_ptr, info_ptr);
 
-    Internal::PngRowPointers row_pointers(im.height(), png_get_rowbytes(png_ptr, info_ptr));
+    // Have libpng consume 16-bit samples in the native byte order.
+    if (bit_depth == 16 && Internal::is_little_endian()) {
+        png_set_swap(png_ptr);
+    }
 
-    // im.copyToHost(); // in case the image is on the gpu
+    Internal::ImageRegion<typename ImageType::ElemType> r = Internal::get_region(im);
+    std::vector<png_byte> row(png_get_rowbytes(png_ptr, info_ptr));
 
-    int c_stride = (im.channels() == 1) ? 0 : ((&im(0, 0, 1)) - (&im(0, 0, 0)));
-    typename ImageType::ElemType *srcPtr = (typename ImageType::ElemType*)im.data();
+    // write data
+    if (!check(!setjmp(png_jmpbuf(png_ptr)), "[write_png_file] Error during writing bytes")) return false;
 
-    for (int y = 0; y < im.height(); y++) {
-        uint8_t *dstPtr = (uint8_t *)(row_pointers.p[y]);
+    for (int y = r.y_min; y < r.y_min + r.height; y++) {
         if (bit_depth == 16) {
-            // convert to uint16_t
-            for (int x = 0; x < im.width(); x++) {
-                for (int c = 0; c < im.channels(); c++) {
-                    uint16_t out;
-                    Internal::convert(srcPtr[c*c_stride], out);
-                    *dstPtr++ = out >> 8;
-                    *dstPtr++ = out & 0xff;
-                }
-                srcPtr++;
-            }
-        } else if (bit_depth == 8) {
-            // convert to uint8_t
-            for (int x = 0; x < im.width(); x++) {
-                for (int c = 0; c < im.channels(); c++) {
-                    uint8_t out;
-                    Internal::convert(srcPtr[c*c_stride], out);
-                    *dstPtr++ = out;
-                }
-                srcPtr++;
-            }
+            Internal::convert_to_interleaved(r, r.row(y), (uint16_t *)row.data());
         } else {
-            if (!check(bit_depth == 8 || bit_depth == 16, "We only support saving 8- and 16-bit images.")) return false;
+            Internal::convert_to_interleaved(r, r.row(y), (uint8_t *)row.data());
         }
+        png_write_row(png_ptr, row.data());
     }
 
-    // write data
-    if (!check(!setjmp(png_jmpbuf(png_ptr)), "[write_png_file] Error during writing bytes")) return false;
-
-    png_write_image(png_ptr, row_pointers.p);
-
     // finish write
     if (!check(!setjmp(png_jmpbuf(png_ptr)), "[write_png_file] Error during end of write")) return false;
 
@@ -671,50 +907,19 @@ bool load_jpg(const std::string &filename, ImageType *im) {
     check(false, "jpg not supported in this build\n");
     return false;
 #else
-    struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-
-    Internal::FileOpener f(filename.c_str(), "rb");
-    if (!check(f.f != nullptr,
-               "File %s could not be opened for reading\n", filename.c_str())) {
-        return false;
-    }
-
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, f.f);
-
-    jpeg_read_header(&cinfo, TRUE);
-    jpeg_start_decompress(&cinfo);
-
-    int channels = cinfo.output_components;
-    if (channels > 1) {
-        *im = ImageType(cinfo.output_width, cinfo.output_height, channels);
-    } else {
-        *im = ImageType(cinfo.output_width, cinfo.output_height);
-    }
-    std::vector<JSAMPLE> row(im->width() * channels);
-
-    for (int y = 0; y < im->height(); y++) {
-        JSAMPLE *src = row.data();
-        jpeg_read_scanlines(&cinfo, &src, 1);
-        if (channels > 1) {
-            for (int x = 0; x < im->width(); x++) {
-                for (int c = 0; c < channels; c++) {
-                    (*im)(x, y, c) = *src++;
-                }
-            }
-        } else {
-            for (int x = 0; x < im->width(); x++) {
-                (*im)(x, y) = *src++;
-            }
-        }
-    }
-
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
+    return Internal::load_jpg_region<ImageType, check>(filename, im, true);
+#endif
+}
 
-    return true;
+// Decode the part of a jpg covered by the already-allocated image *im
+// directly into it. See load_png_into.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_jpg_into(const std::string &filename, ImageType *im) {
+#ifdef HALIDE_NO_JPEG
+    check(false, "jpg not supported in this build\n");
+    return false;
+#else
+    return Internal::load_jpg_region<ImageType, check>(filename, im, false);
 #endif
 }
 
@@ -752,6 +957,59 @@ bool save(ImageType &im, const std::string &filename) {
     }
 }
 
+// Decode the part of a file covered by the already-allocated image
+// *im directly into it. Only png and jpg are supported. Returns false
+// upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_into(const std::string &filename, ImageType *im) {
+    if (Internal::ends_with_ignore_case(filename, ".png")) {
+        return load_png_into<ImageType, check>(filename, im);
+    } else if (Internal::ends_with_ignore_case(filename, ".jpg") ||
+               Internal::ends_with_ignore_case(filename, ".jpeg")) {
+        return load_jpg_into<ImageType, check>(filename, im);
+    } else {
+        return check(false, "[load_into] unsupported file extension (png|jpg supported)");
+    }
+}
+
+// Load several files, decoding them on up to num_threads threads at
+// once (one per core if num_threads is zero). Returns false if any of
+// them failed to load.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_all(const std::vector<std::string> &filenames, std::vector<ImageType> *images, int num_threads = 0) {
+    images->resize(filenames.size());
+    std::atomic<bool> ok(true);
+    Internal::parallel_for_each_file((int)filenames.size(), num_threads, [&](int i) {
+        if (!load<ImageType, check>(filenames[i], &(*images)[i])) {
+            ok = false;
+        }
+    });
+    return ok;
+}
+
+// Save several images, encoding them on up to num_threads threads at
+// once (one per core if num_threads is zero). Returns false if any of
+// them failed to save.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool save_all(std::vector<ImageType> &images, const std::vector<std::string> &filenames, int num_threads = 0) {
+    if (!check(images.size() == filenames.size(),
+               "[save_all] %d images but %d filenames\n", (int)images.size(), (int)filenames.size())) {
+        return false;
+    }
+    // copy_to_host() isn't safe to call concurrently on images that
+    // share a device allocation, so do it up front.
+    for (ImageType &im : images) {
+        im.copy_to_host();
+    }
+    std::atomic<bool> ok(true);
+    Internal::parallel_for_each_file((int)filenames.size(), num_threads, [&](int i) {
+        if (!save<ImageType, check>(images[i], filenames[i])) {
+            ok = false;
+        }
+    });
+    return ok;
+}
+
 // Fancy wrapper to call load() with CheckFail, inferring the return type;
 // this allows you to simply use
 //